@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace benchmark
+{
+  /**
+   * Returns the number of repetitions each measurement should be run, which
+   * can be overridden with the PLORTH_BENCHMARK_ITERATIONS environment
+   * variable.
+   */
+  inline int
+  iterations()
+  {
+    const auto value = std::getenv("PLORTH_BENCHMARK_ITERATIONS");
+
+    return value ? std::max(std::atoi(value), 1) : 10;
+  }
+
+  /**
+   * Runs given function the given number of times and returns the average
+   * wall clock time of a single run in milliseconds.
+   */
+  template<class Function>
+  double
+  measure(Function&& function, int count = iterations())
+  {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < count; ++i)
+    {
+      function();
+    }
+
+    return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start
+    ).count() / count;
+  }
+
+  /**
+   * Prints result of single measurement, along with throughput if number of
+   * processed bytes is known.
+   */
+  inline void
+  report(const char* name, double milliseconds, std::size_t bytes = 0)
+  {
+    if (bytes > 0)
+    {
+      std::printf(
+        "%-40s %10.3f ms %10.1f MB/s\n",
+        name,
+        milliseconds,
+        (bytes / (1024.0 * 1024.0)) / (milliseconds / 1000.0)
+      );
+    } else {
+      std::printf("%-40s %10.3f ms\n", name, milliseconds);
+    }
+  }
+
+  /**
+   * Generates UTF-8 encoded Plorth program of approximately given size in
+   * bytes, mixing all token types together with comments and non-ASCII
+   * text.
+   */
+  inline std::string
+  generate_source(std::size_t size)
+  {
+    std::string source;
+
+    for (std::size_t i = 0; source.length() < size; ++i)
+    {
+      const auto n = std::to_string(i);
+
+      source += "# Definition number " + n + " \xe2\x80\x93 p\xc3\xa4\xc3\xa4\n";
+      source += "(dup 1 + swap \"Hello, w\xc3\xb6rld " + n + "!\\n\" println)"
+        " -> word-" + n + "\n";
+      source += "[1, 2, {\"key\": \"value " + n + "\", \"list\": [a, b, c]},"
+        " 'x'] drop\n";
+    }
+
+    // Trailing whitespace is not allowed after the last token.
+    while (!source.empty() && std::isspace(source.back()))
+    {
+      source.pop_back();
+    }
+
+    return source;
+  }
+}
@@ -0,0 +1,112 @@
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+
+#include <plorth/parser/batch.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t file_count = 1000;
+static const std::size_t file_size = 16 * 1024;
+
+static std::vector<std::string>
+write_files(const std::filesystem::path& directory)
+{
+  std::vector<std::string> paths;
+
+  std::filesystem::create_directories(directory);
+  for (std::size_t i = 0; i < file_count; ++i)
+  {
+    const auto path = directory / ("module-" + std::to_string(i) + ".plorth");
+    std::ofstream stream(path, std::ios::out | std::ios::binary);
+
+    // Vary the size of the files, so that some workers get more work.
+    stream << benchmark::generate_source(file_size * (1 + i % 4));
+    paths.push_back(path.string());
+  }
+
+  return paths;
+}
+
+int
+main()
+{
+  const auto directory = std::filesystem::temp_directory_path()
+    / "plorth-benchmark-batch";
+  const auto paths = write_files(directory);
+  const std::size_t max_threads = std::max(
+    std::thread::hardware_concurrency(),
+    1u
+  );
+  std::vector<std::size_t> thread_counts;
+
+  benchmark::report(
+    "sequential, std::ifstream",
+    benchmark::measure([&]()
+    {
+      std::vector<plorth::parser::parse_result> results;
+
+      // Results are kept, like parse_files() does.
+      results.reserve(paths.size());
+      for (const auto& path : paths)
+      {
+        std::ifstream stream(path, std::ios::in | std::ios::binary);
+        const std::string source(
+          (std::istreambuf_iterator<char>(stream)),
+          std::istreambuf_iterator<char>()
+        );
+        plorth::parser::position position = {
+          plorth::parser::utf8::decode(path),
+          1,
+          1
+        };
+
+        results.push_back(plorth::parser::parse(source, position));
+        assert(!!results.back());
+      }
+    })
+  );
+
+  // Powers of two, followed by the number of hardware threads.
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2)
+  {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  for (const auto threads : thread_counts)
+  {
+    const auto name = "parse_files, " + std::to_string(threads) + " threads";
+    const auto shared_name = name + ", shared symbols";
+
+    // Starting the thread pool is included in the measurement.
+    benchmark::report(
+      name.c_str(),
+      benchmark::measure([&]()
+      {
+        plorth::parser::thread_pool pool(threads);
+        const auto results = plorth::parser::parse_files(paths, pool);
+
+        assert(results.size() == paths.size());
+      })
+    );
+
+    benchmark::report(
+      shared_name.c_str(),
+      benchmark::measure([&]()
+      {
+        plorth::parser::thread_pool pool(threads);
+        plorth::parser::symbol_table table(true);
+        const auto results = plorth::parser::parse_files(
+          paths,
+          pool,
+          plorth::parser::ast::builder<>(table)
+        );
+
+        assert(results.size() == paths.size());
+      })
+    );
+  }
+
+  std::filesystem::remove_all(directory);
+}
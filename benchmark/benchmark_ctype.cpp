@@ -0,0 +1,84 @@
+#include <cctype>
+
+#include <plorth/parser.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+static volatile std::size_t sink;
+
+// Classification the parser used before the lookup table was introduced.
+static inline bool
+isword_comparisons(char32_t c)
+{
+  return c != '(' && c != ')' && c != '[' && c != ']' && c != '{'
+    && c != '}' && c != ','
+    && peelo::unicode::ctype::isgraph(c);
+}
+
+template<class SpaceT, class WordT>
+static std::size_t
+classify(const std::u32string& source, SpaceT isspace, WordT isword)
+{
+  std::size_t count = 0;
+
+  for (const auto c : source)
+  {
+    count += isspace(c) ? 1 : isword(c) ? 2 : 0;
+  }
+
+  return count;
+}
+
+static void
+run(const char* name, const std::u32string& source)
+{
+  const auto bytes = source.length() * sizeof(char32_t);
+
+  std::printf("%s:\n", name);
+
+  benchmark::report(
+    "  std::isspace and comparisons",
+    benchmark::measure([&]()
+    {
+      sink = classify(
+        source,
+        // std::isspace() is undefined for values above 255.
+        [](char32_t c) { return c < 256 && std::isspace(c); },
+        isword_comparisons
+      );
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "  lookup table",
+    benchmark::measure([&]()
+    {
+      sink = classify(
+        source,
+        plorth::parser::utils::isspace,
+        plorth::parser::utils::isword
+      );
+    }),
+    bytes
+  );
+}
+
+int
+main()
+{
+  const auto ascii = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  std::u32string unicode;
+
+  while (unicode.length() < ascii.length())
+  {
+    unicode += U"\u00e4\u00f6 \u043f\u0440\u0438\u0432\u0435\u0442 "
+      U"\u3053\u3093\u306b\u3061\u306f\u3000\U0001f600 (x) ";
+  }
+
+  run("ASCII-heavy input", ascii);
+  run("Unicode-heavy input", unicode);
+}
@@ -0,0 +1,148 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/traversal.hpp>
+
+#include "./benchmark.hpp"
+
+using plorth::parser::ast::string;
+using plorth::parser::ast::token;
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+static std::size_t live_bytes = 0;
+
+// GCC cannot see that the replacement operators below are paired correctly.
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void*
+operator new(std::size_t size)
+{
+  if (auto pointer = std::malloc(size))
+  {
+    live_bytes += size;
+
+    return pointer;
+  }
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t size) noexcept
+{
+  live_bytes -= size;
+  std::free(pointer);
+}
+
+static plorth::parser::parse_result
+parse(const std::u32string& source, bool deferred_escapes)
+{
+  auto current = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<benchmark>", 1, 1 };
+  plorth::parser::ast::builder<> builder;
+
+  builder.set_source_views(true);
+  builder.set_deferred_escapes(deferred_escapes);
+
+  return plorth::parser::parse(current, end, position, builder);
+}
+
+// Reads contents of every string literal and returns their total length.
+static std::size_t
+read_strings(const std::vector<std::shared_ptr<token>>& tokens)
+{
+  plorth::parser::ast::pre_order_traversal traversal(tokens);
+  std::size_t length = 0;
+
+  for (const auto& token : traversal)
+  {
+    if (token->type() == token::type::string)
+    {
+      length += std::static_pointer_cast<string>(token)->value().length();
+    }
+  }
+
+  return length;
+}
+
+int
+main()
+{
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  const auto bytes = source.length() * sizeof(char32_t);
+
+  {
+    const auto before = live_bytes;
+    const auto eager = parse(source, false);
+    const auto eager_bytes = live_bytes - before;
+    const auto deferred = parse(source, true);
+    const auto deferred_bytes = live_bytes - before - eager_bytes;
+
+    assert(!!eager && !!deferred);
+    std::printf(
+      "AST memory: decoded %zu bytes, deferred %zu bytes\n",
+      eager_bytes,
+      deferred_bytes
+    );
+  }
+
+  benchmark::report(
+    "decoded while parsing",
+    benchmark::measure([&]()
+    {
+      const auto result = parse(source, false);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "deferred",
+    benchmark::measure([&]()
+    {
+      const auto result = parse(source, true);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "decoded while parsing, every string read",
+    benchmark::measure([&]()
+    {
+      const auto result = parse(source, false);
+
+      assert(!!result);
+      static_cast<void>(read_strings(*result));
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "deferred, every string read",
+    benchmark::measure([&]()
+    {
+      const auto result = parse(source, true);
+
+      assert(!!result);
+      static_cast<void>(read_strings(*result));
+    }),
+    bytes
+  );
+}
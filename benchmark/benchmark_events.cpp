@@ -0,0 +1,140 @@
+#include <cassert>
+
+#include <plorth/parser/events.hpp>
+#include <plorth/parser/visitor.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+
+// Counts string literals and symbols in the AST, descending into arrays,
+// objects and quotes.
+class counting_visitor : public plorth::parser::ast::visitor<std::size_t&>
+{
+public:
+  void visit_array(
+    const std::shared_ptr<plorth::parser::ast::array>& token,
+    std::size_t& count
+  ) const
+  {
+    for (const auto& element : token->elements())
+    {
+      visit(element, count);
+    }
+  }
+
+  void visit_object(
+    const std::shared_ptr<plorth::parser::ast::object>& token,
+    std::size_t& count
+  ) const
+  {
+    for (const auto& property : token->properties())
+    {
+      visit(property.second, count);
+    }
+  }
+
+  void visit_quote(
+    const std::shared_ptr<plorth::parser::ast::quote>& token,
+    std::size_t& count
+  ) const
+  {
+    for (const auto& child : token->children())
+    {
+      visit(child, count);
+    }
+  }
+
+  void visit_string(
+    const std::shared_ptr<plorth::parser::ast::string>&,
+    std::size_t& count
+  ) const
+  {
+    ++count;
+  }
+
+  void visit_symbol(
+    const std::shared_ptr<plorth::parser::ast::symbol>&,
+    std::size_t& count
+  ) const
+  {
+    ++count;
+  }
+};
+
+// Counts the same values from parse events.
+struct counting_handler : public plorth::parser::event_handler
+{
+  std::size_t count = 0;
+
+  inline void on_string(
+    const plorth::parser::position&,
+    std::uint64_t,
+    const std::u32string_view&
+  )
+  {
+    ++count;
+  }
+
+  inline void on_symbol(
+    const plorth::parser::position&,
+    std::uint64_t,
+    const std::u32string_view&
+  )
+  {
+    ++count;
+  }
+};
+
+int
+main()
+{
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  const auto bytes = source.length() * sizeof(char32_t);
+  std::size_t expected = 0;
+
+  benchmark::report(
+    "parse and visit the AST",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(current, end, position);
+      const counting_visitor visitor;
+      std::size_t count = 0;
+
+      assert(!!result);
+      for (const auto& token : *result)
+      {
+        visitor.visit(token, count);
+      }
+      expected = count;
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "parse events",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      counting_handler handler;
+      const auto error = plorth::parser::parse_events(
+        current,
+        end,
+        position,
+        handler
+      );
+
+      assert(!error);
+      assert(handler.count == expected);
+      static_cast<void>(error);
+    }),
+    bytes
+  );
+}
@@ -0,0 +1,80 @@
+#include <cassert>
+
+#include <plorth/parser/incremental.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 1024 * 1024;
+
+// Types a character at given offset and deletes it again, either by
+// reparsing the whole source code or incrementally.
+static void
+run(
+  const char* name,
+  const std::u32string& original,
+  std::size_t offset,
+  char32_t c
+)
+{
+  const plorth::parser::position initial = { U"<benchmark>", 1, 1 };
+  auto edited = original;
+
+  edited.insert(offset, 1, c);
+
+  const auto full = [&](const std::u32string& source)
+  {
+    auto current = std::cbegin(source);
+    const auto end = std::cend(source);
+    auto position = initial;
+
+    return plorth::parser::parse(current, end, position);
+  };
+  auto tokens = *full(original);
+
+  benchmark::report(
+    (std::string(name) + ", full").c_str(),
+    benchmark::measure([&]()
+    {
+      const auto result1 = full(edited);
+      const auto result2 = full(original);
+
+      assert(!!result1 && !!result2);
+    }) / 2
+  );
+  benchmark::report(
+    (std::string(name) + ", incremental").c_str(),
+    benchmark::measure([&]()
+    {
+      auto result = plorth::parser::reparse(
+        tokens,
+        edited,
+        { offset, 0, 1 },
+        initial
+      );
+
+      assert(!!result);
+      result = plorth::parser::reparse(
+        *result,
+        original,
+        { offset, 1, 0 },
+        initial
+      );
+      assert(!!result);
+      tokens = std::move(*result);
+    }) / 2
+  );
+}
+
+int
+main()
+{
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  const auto middle = source.length() / 2;
+
+  run("string literal", source, source.find(U"Hello", middle) + 1, U'x');
+  run("quote", source, source.find(U"dup", middle) + 1, U'x');
+  run("top level", source, source.find(U"drop", middle) + 4, U' ');
+  run("beginning", source, source.find(U"dup") + 1, U'x');
+}
@@ -0,0 +1,137 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <plorth/parser/lazy.hpp>
+#include <plorth/parser/traversal.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+static std::size_t live_bytes = 0;
+
+// GCC cannot see that the replacement operators below are paired correctly.
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void*
+operator new(std::size_t size)
+{
+  if (auto pointer = std::malloc(size))
+  {
+    live_bytes += size;
+
+    return pointer;
+  }
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t size) noexcept
+{
+  live_bytes -= size;
+  std::free(pointer);
+}
+
+template<class BuilderT>
+static plorth::parser::basic_parse_result<BuilderT>
+parse(const std::u32string& source)
+{
+  auto current = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<benchmark>", 1, 1 };
+
+  return plorth::parser::parse(current, end, position, BuilderT());
+}
+
+// Accesses every token, which parses children of every lazy quote, and
+// returns the number of tokens.
+static std::size_t
+touch(const std::vector<std::shared_ptr<plorth::parser::ast::token>>& tokens)
+{
+  plorth::parser::ast::pre_order_traversal traversal(tokens);
+  std::size_t count = 0;
+
+  for (auto it = std::begin(traversal); it != std::end(traversal); ++it)
+  {
+    ++count;
+  }
+
+  return count;
+}
+
+int
+main()
+{
+  using eager_builder = plorth::parser::ast::builder<>;
+  using lazy_builder = plorth::parser::ast::lazy_builder<>;
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  const auto bytes = source.length() * sizeof(char32_t);
+
+  {
+    const auto before = live_bytes;
+    const auto eager = parse<eager_builder>(source);
+    const auto eager_bytes = live_bytes - before;
+    const auto lazy = parse<lazy_builder>(source);
+    const auto lazy_bytes = live_bytes - before - eager_bytes;
+
+    assert(!!eager && !!lazy);
+
+    const auto count = touch(*lazy);
+
+    assert(count == touch(*eager));
+    static_cast<void>(count);
+    std::printf(
+      "AST memory: eager %zu bytes, lazy %zu bytes, lazy after access %zu "
+      "bytes\n",
+      eager_bytes,
+      lazy_bytes,
+      live_bytes - before - eager_bytes
+    );
+  }
+
+  benchmark::report(
+    "eager",
+    benchmark::measure([&]()
+    {
+      const auto result = parse<eager_builder>(source);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "lazy",
+    benchmark::measure([&]()
+    {
+      const auto result = parse<lazy_builder>(source);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "lazy, every quote accessed",
+    benchmark::measure([&]()
+    {
+      const auto result = parse<lazy_builder>(source);
+
+      assert(!!result);
+      static_cast<void>(touch(*result));
+    }),
+    bytes
+  );
+}
@@ -0,0 +1,121 @@
+#include <cassert>
+#include <cstdio>
+#include <thread>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/map_reduce.hpp>
+#include <plorth/parser/traversal.hpp>
+
+#include "./benchmark.hpp"
+
+using plorth::parser::ast::string;
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+
+// Roughly one million tokens.
+static const std::size_t source_size = 8 * 1024 * 1024;
+
+// Counts the tokens of a subtree and the characters in it's strings and
+// symbols, which requires visiting every token.
+static std::size_t
+measure_subtree(const std::shared_ptr<token>& subtree)
+{
+  plorth::parser::ast::pre_order_traversal traversal(subtree);
+  std::size_t result = 0;
+
+  for (const auto& token : traversal)
+  {
+    ++result;
+    if (token->type() == token::type::string)
+    {
+      result += std::static_pointer_cast<string>(token)->view().length();
+    }
+    else if (token->type() == token::type::symbol)
+    {
+      result += std::static_pointer_cast<symbol>(token)->view().length();
+    }
+  }
+
+  return result;
+}
+
+static std::size_t
+add(std::size_t a, std::size_t b)
+{
+  return a + b;
+}
+
+int
+main()
+{
+  plorth::parser::position position = { U"<benchmark>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    benchmark::generate_source(source_size),
+    position
+  );
+  const std::size_t max_threads = std::max(
+    std::thread::hardware_concurrency(),
+    1u
+  );
+  std::size_t tokens = 0;
+  std::size_t expected = 0;
+
+  assert(!!result);
+  for (const auto& token : plorth::parser::ast::pre_order_traversal(*result))
+  {
+    static_cast<void>(token);
+    ++tokens;
+  }
+  for (const auto& subtree : *result)
+  {
+    expected += measure_subtree(subtree);
+  }
+  std::printf(
+    "%zu tokens in %zu top level subtrees\n",
+    tokens,
+    result->size()
+  );
+
+  benchmark::report(
+    "sequential",
+    benchmark::measure([&]()
+    {
+      std::size_t total = 0;
+
+      for (const auto& subtree : *result)
+      {
+        total += measure_subtree(subtree);
+      }
+      assert(total == expected);
+      static_cast<void>(total);
+    })
+  );
+
+  std::vector<std::size_t> thread_counts;
+
+  // Powers of two, followed by the number of hardware threads.
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2)
+  {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  for (const auto threads : thread_counts)
+  {
+    plorth::parser::thread_pool pool(threads);
+    const auto name = "parallel, " + std::to_string(threads) + " threads";
+
+    benchmark::report(
+      name.c_str(),
+      benchmark::measure([&]()
+      {
+        const auto total = plorth::parser::ast::parallel_map_reduce<
+          std::size_t
+        >(*result, pool, 0, measure_subtree, add);
+
+        assert(total == expected);
+        static_cast<void>(total);
+      })
+    );
+  }
+}
@@ -0,0 +1,68 @@
+#include <cassert>
+
+#include <plorth/parser/parallel.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 32 * 1024 * 1024;
+
+int
+main()
+{
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  const auto bytes = source.length() * sizeof(char32_t);
+  const std::size_t max_threads = std::max(
+    std::thread::hardware_concurrency(),
+    1u
+  );
+
+  benchmark::report(
+    "sequential",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(current, end, position);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  std::vector<std::size_t> thread_counts;
+
+  // Powers of two, followed by the number of hardware threads.
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2)
+  {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  for (const auto threads : thread_counts)
+  {
+    plorth::parser::thread_pool pool(threads);
+    const auto name = "parallel, " + std::to_string(threads) + " threads";
+
+    benchmark::report(
+      name.c_str(),
+      benchmark::measure([&]()
+      {
+        auto current = std::cbegin(source);
+        const auto end = std::cend(source);
+        plorth::parser::position position = { U"<benchmark>", 1, 1 };
+        const auto result = plorth::parser::parse_parallel(
+          current,
+          end,
+          position,
+          pool
+        );
+
+        assert(!!result);
+      }),
+      bytes
+    );
+  }
+}
@@ -0,0 +1,48 @@
+#include <cassert>
+
+#include <plorth/parser/parse_tree.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+
+int
+main()
+{
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  const auto bytes = source.length() * sizeof(char32_t);
+
+  benchmark::report(
+    "parse with std::allocator",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(current, end, position);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "parse into parse_tree",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse_tree::parse(
+        current,
+        end,
+        position
+      );
+
+      assert(!!result);
+    }),
+    bytes
+  );
+}
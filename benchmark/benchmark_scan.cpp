@@ -0,0 +1,163 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+static volatile std::size_t sink;
+
+// Generates data-style Plorth program, which consists mostly of long string
+// literals, comments and indentation.
+static std::u32string
+generate_data_source(std::size_t size)
+{
+  std::u32string source;
+
+  for (std::size_t i = 0; source.length() < size; ++i)
+  {
+    source += U"# Record number ";
+    source += std::u32string(60, U'-');
+    source += U"\n{\n        \"description\": \"";
+    for (int j = 0; j < 8; ++j)
+    {
+      source += U"Lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+    }
+    source += U"\",\n        \"identifier\": some-rather-long-identifier-name";
+    source += U"\n}\n";
+  }
+  source += U"end";
+
+  return source;
+}
+
+// Walks through the whole source code with given kernels, stepping over
+// every character the kernels stop at.
+template<class CharT, class StringKernelT, class LineKernelT,
+         class BlankKernelT, class WordKernelT>
+static std::size_t
+walk(
+  const std::basic_string<CharT>& source,
+  StringKernelT find_string_delimiter,
+  LineKernelT find_line_end,
+  BlankKernelT skip_blanks,
+  WordKernelT skip_word
+)
+{
+  const auto end = source.data() + source.length();
+  std::size_t stops = 0;
+
+  for (auto current = source.data(); current < end; ++stops)
+  {
+    const auto run_end = (stops % 4 == 0)
+      ? find_string_delimiter(current, end, U'"')
+      : (stops % 4 == 1)
+      ? find_line_end(current, end)
+      : (stops % 4 == 2)
+      ? skip_blanks(current, end)
+      : skip_word(current, end);
+
+    current = run_end < end ? run_end + 1 : end;
+  }
+
+  return stops;
+}
+
+int
+main()
+{
+  namespace scan = plorth::parser::scan;
+  const auto source = generate_data_source(source_size);
+  const auto bytes = source.length() * sizeof(char32_t);
+
+  std::printf("instruction set: %s\n", scan::instruction_set);
+
+  benchmark::report(
+    "scalar kernels",
+    benchmark::measure([&]()
+    {
+      sink = walk(
+        source,
+        scan::scalar::find_string_delimiter,
+        scan::scalar::find_line_end,
+        scan::scalar::skip_blanks,
+        scan::scalar::skip_word
+      );
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "vectorized kernels",
+    benchmark::measure([&]()
+    {
+      sink = walk(
+        source,
+        scan::find_string_delimiter,
+        scan::find_line_end,
+        scan::skip_blanks,
+        scan::skip_word
+      );
+    }),
+    bytes
+  );
+
+  // The generated source code is ASCII only, so it's UTF-8 as such.
+  const std::string utf8_source(std::cbegin(source), std::cend(source));
+
+  benchmark::report(
+    "scalar UTF-8 kernels",
+    benchmark::measure([&]()
+    {
+      sink = walk(
+        utf8_source,
+        scan::ascii::scalar::find_string_delimiter,
+        scan::ascii::scalar::find_line_end,
+        scan::ascii::scalar::skip_blanks,
+        scan::ascii::scalar::skip_word
+      );
+    }),
+    utf8_source.length()
+  );
+
+  benchmark::report(
+    "vectorized UTF-8 kernels",
+    benchmark::measure([&]()
+    {
+      sink = walk(
+        utf8_source,
+        scan::ascii::find_string_delimiter,
+        scan::ascii::find_line_end,
+        scan::ascii::skip_blanks,
+        scan::ascii::skip_word
+      );
+    }),
+    utf8_source.length()
+  );
+
+  benchmark::report(
+    "parse data-style source",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(current, end, position);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "parse data-style UTF-8 source",
+    benchmark::measure([&]()
+    {
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(utf8_source, position);
+
+      assert(!!result);
+    }),
+    utf8_source.length()
+  );
+}
@@ -0,0 +1,59 @@
+#include <cassert>
+
+#include <plorth/parser/structural_index.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+
+int
+main()
+{
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  const auto bytes = source.length() * sizeof(char32_t);
+
+  benchmark::report(
+    "stage 1: structural index",
+    benchmark::measure([&]()
+    {
+      const plorth::parser::structural_index index(source);
+
+      assert(index.balanced());
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "parse",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(current, end, position);
+
+      assert(!!result);
+    }),
+    bytes
+  );
+
+  benchmark::report(
+    "parse in two stages",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(source);
+      const auto end = std::cend(source);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse_indexed(
+        current,
+        end,
+        position
+      );
+
+      assert(!!result);
+    }),
+    bytes
+  );
+}
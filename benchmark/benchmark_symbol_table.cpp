@@ -0,0 +1,139 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <plorth/parser.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+static std::size_t live_bytes = 0;
+static std::size_t allocations = 0;
+
+// GCC cannot see that the replacement operators below are paired correctly.
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Standard containers and std::shared_ptr release their memory through the
+// sized delete operator, which allows the number of bytes currently in use
+// to be tracked without storing the size of each allocation.
+void*
+operator new(std::size_t size)
+{
+  if (auto pointer = std::malloc(size))
+  {
+    live_bytes += size;
+    ++allocations;
+
+    return pointer;
+  }
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t size) noexcept
+{
+  live_bytes -= size;
+  std::free(pointer);
+}
+
+struct memory_usage
+{
+  std::size_t bytes;
+  std::size_t allocations;
+};
+
+template<class BuilderT>
+static memory_usage
+measure_memory(const std::u32string& source, const BuilderT& builder)
+{
+  auto current = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<benchmark>", 1, 1 };
+  const auto bytes_before = live_bytes;
+  const auto allocations_before = allocations;
+  const auto result = plorth::parser::parse(current, end, position, builder);
+
+  assert(!!result);
+
+  return { live_bytes - bytes_before, allocations - allocations_before };
+}
+
+static void
+print_memory(const char* name, const memory_usage& usage)
+{
+  std::printf(
+    "%-32s %zu bytes, %zu allocations\n",
+    name,
+    usage.bytes,
+    usage.allocations
+  );
+}
+
+int
+main()
+{
+  const auto source = plorth::parser::utf8::decode(
+    benchmark::generate_source(source_size)
+  );
+  plorth::parser::symbol_table table;
+  plorth::parser::ast::builder<> source_view_builder;
+
+  source_view_builder.set_source_views(true);
+
+  const auto without_table = measure_memory(
+    source,
+    plorth::parser::ast::builder<>()
+  );
+  const auto with_table = measure_memory(
+    source,
+    plorth::parser::ast::builder<>(table)
+  );
+  const auto with_source_views = measure_memory(source, source_view_builder);
+
+  print_memory("AST without symbol table:", without_table);
+  print_memory("AST with symbol table:", with_table);
+  print_memory("AST with source views:", with_source_views);
+  std::printf(
+    "saved with symbol table: %.1f %% (%zu distinct identifiers)\n",
+    100.0 - (100.0 * with_table.bytes / without_table.bytes),
+    table.size()
+  );
+  std::printf(
+    "saved with source views: %.1f %%\n",
+    100.0 - (100.0 * with_source_views.bytes / without_table.bytes)
+  );
+
+  benchmark::report(
+    "parse without symbol table",
+    benchmark::measure([&]()
+    {
+      measure_memory(source, plorth::parser::ast::builder<>());
+    })
+  );
+
+  benchmark::report(
+    "parse with symbol table",
+    benchmark::measure([&]()
+    {
+      measure_memory(source, plorth::parser::ast::builder<>(table));
+    })
+  );
+
+  benchmark::report(
+    "parse with source views",
+    benchmark::measure([&]()
+    {
+      measure_memory(source, source_view_builder);
+    })
+  );
+}
@@ -0,0 +1,46 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+
+int
+main()
+{
+  const auto source = benchmark::generate_source(source_size);
+
+  benchmark::report(
+    "decode to UTF-32, then parse",
+    benchmark::measure([&]()
+    {
+      const auto decoded = plorth::parser::utf8::decode(source);
+      auto current = std::cbegin(decoded);
+      const auto end = std::cend(decoded);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(current, end, position);
+
+      assert(!!result);
+    }),
+    source.length()
+  );
+
+  benchmark::report(
+    "parse UTF-8 directly",
+    benchmark::measure([&]()
+    {
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(source, position);
+
+      assert(!!result);
+    }),
+    source.length()
+  );
+
+  std::printf(
+    "source size: %zu bytes as UTF-8, %zu bytes as UTF-32\n",
+    source.length(),
+    plorth::parser::utf8::decode(source).length() * sizeof(char32_t)
+  );
+}
@@ -0,0 +1,54 @@
+#include <cassert>
+
+#include <plorth/parser/validate.hpp>
+
+#include "./benchmark.hpp"
+
+static const std::size_t source_size = 8 * 1024 * 1024;
+
+int
+main()
+{
+  const auto source = benchmark::generate_source(source_size);
+  const auto decoded = plorth::parser::utf8::decode(source);
+
+  benchmark::report(
+    "parse UTF-8",
+    benchmark::measure([&]()
+    {
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto result = plorth::parser::parse(source, position);
+
+      assert(!!result);
+    }),
+    source.length()
+  );
+
+  benchmark::report(
+    "validate UTF-8",
+    benchmark::measure([&]()
+    {
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto error = plorth::parser::validate(source, position);
+
+      assert(!error);
+      static_cast<void>(error);
+    }),
+    source.length()
+  );
+
+  benchmark::report(
+    "validate UTF-32",
+    benchmark::measure([&]()
+    {
+      auto current = std::cbegin(decoded);
+      const auto end = std::cend(decoded);
+      plorth::parser::position position = { U"<benchmark>", 1, 1 };
+      const auto error = plorth::parser::validate(current, end, position);
+
+      assert(!error);
+      static_cast<void>(error);
+    }),
+    decoded.length() * sizeof(char32_t)
+  );
+}
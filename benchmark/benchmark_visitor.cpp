@@ -0,0 +1,152 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/visitor.hpp>
+
+#include "./benchmark.hpp"
+
+using plorth::parser::ast::array;
+using plorth::parser::ast::object;
+using plorth::parser::ast::quote;
+using plorth::parser::ast::string;
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+using plorth::parser::ast::word;
+
+static const std::size_t source_size = 16 * 1024 * 1024;
+static const int passes = 10;
+
+// Counts every token in the tree with the virtual visitor.
+class virtual_counter : public plorth::parser::ast::visitor<std::size_t&>
+{
+public:
+  void visit_array(
+    const std::shared_ptr<array>& token,
+    std::size_t& count
+  ) const
+  {
+    ++count;
+    for (const auto& element : token->elements())
+    {
+      visit(element, count);
+    }
+  }
+
+  void visit_object(
+    const std::shared_ptr<object>& token,
+    std::size_t& count
+  ) const
+  {
+    ++count;
+    for (const auto& property : token->properties())
+    {
+      visit(property.second, count);
+    }
+  }
+
+  void visit_quote(
+    const std::shared_ptr<quote>& token,
+    std::size_t& count
+  ) const
+  {
+    ++count;
+    for (const auto& child : token->children())
+    {
+      visit(child, count);
+    }
+  }
+
+  void visit_token(const std::shared_ptr<token>&, std::size_t& count) const
+  {
+    ++count;
+  }
+};
+
+// Counts every token in the tree with the static visitor.
+class static_counter
+  : public plorth::parser::ast::static_visitor<static_counter>
+{
+public:
+  void visit_array(const array& token, std::size_t& count)
+  {
+    ++count;
+    for (const auto& element : token.elements())
+    {
+      visit(*element, count);
+    }
+  }
+
+  void visit_object(const object& token, std::size_t& count)
+  {
+    ++count;
+    for (const auto& property : token.properties())
+    {
+      visit(*property.second, count);
+    }
+  }
+
+  void visit_quote(const quote& token, std::size_t& count)
+  {
+    ++count;
+    for (const auto& child : token.children())
+    {
+      visit(*child, count);
+    }
+  }
+
+  void visit_token(const token&, std::size_t& count)
+  {
+    ++count;
+  }
+};
+
+int
+main()
+{
+  plorth::parser::position position = { U"<benchmark>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    benchmark::generate_source(source_size),
+    position
+  );
+  std::size_t expected = 0;
+
+  assert(!!result);
+
+  benchmark::report(
+    "virtual visitor",
+    benchmark::measure([&]()
+    {
+      const virtual_counter visitor;
+      std::size_t count = 0;
+
+      for (int i = 0; i < passes; ++i)
+      {
+        for (const auto& token : *result)
+        {
+          visitor.visit(token, count);
+        }
+      }
+      expected = count;
+    })
+  );
+
+  benchmark::report(
+    "static visitor",
+    benchmark::measure([&]()
+    {
+      static_counter visitor;
+      std::size_t count = 0;
+
+      for (int i = 0; i < passes; ++i)
+      {
+        for (const auto& token : *result)
+        {
+          visitor.visit(*token, count);
+        }
+      }
+      assert(count == expected);
+    })
+  );
+
+  std::printf("%zu tokens visited per measurement\n", expected);
+}
@@ -0,0 +1,121 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/visitor_runner.hpp>
+
+#include "./benchmark.hpp"
+
+using plorth::parser::ast::string;
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+using plorth::parser::ast::word;
+
+static const std::size_t source_size = 4 * 1024 * 1024;
+static const int rule_count = 40;
+
+// Imitates a lint rule, which looks for tokens of single type containing a
+// given character.
+class rule : public plorth::parser::ast::visitor<std::size_t&>
+{
+public:
+  explicit rule(int number)
+    : m_character(static_cast<char32_t>(U'a' + number % 26))
+    , m_type(number % 3 == 0
+      ? token::type::string
+      : number % 3 == 1
+      ? token::type::symbol
+      : token::type::word) {}
+
+  inline enum token::type type() const
+  {
+    return m_type;
+  }
+
+  void visit_string(const std::shared_ptr<string>& token, std::size_t& count)
+    const
+  {
+    if (m_type == token::type::string
+        && token->value().find(m_character) != std::u32string::npos)
+    {
+      ++count;
+    }
+  }
+
+  void visit_symbol(const std::shared_ptr<symbol>& token, std::size_t& count)
+    const
+  {
+    if (m_type == token::type::symbol
+        && token->view().find(m_character) != std::u32string_view::npos)
+    {
+      ++count;
+    }
+  }
+
+  void visit_word(const std::shared_ptr<word>& token, std::size_t& count)
+    const
+  {
+    if (m_type == token::type::word
+        && token->symbol()->view().find(m_character)
+          != std::u32string_view::npos)
+    {
+      ++count;
+    }
+  }
+
+private:
+  const char32_t m_character;
+  const enum token::type m_type;
+};
+
+int
+main()
+{
+  plorth::parser::position position = { U"<benchmark>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    benchmark::generate_source(source_size),
+    position
+  );
+  std::vector<rule> rules;
+  std::size_t expected = 0;
+
+  assert(!!result);
+  for (int i = 0; i < rule_count; ++i)
+  {
+    rules.emplace_back(i);
+  }
+
+  benchmark::report(
+    "rules one after another",
+    benchmark::measure([&]()
+    {
+      std::size_t count = 0;
+
+      for (const auto& rule : rules)
+      {
+        plorth::parser::ast::pre_order_traversal traversal(*result);
+
+        for (const auto& token : traversal)
+        {
+          rule.visit(token, count);
+        }
+      }
+      expected = count;
+    })
+  );
+
+  benchmark::report(
+    "fused runner",
+    benchmark::measure([&]()
+    {
+      plorth::parser::ast::visitor_runner<std::size_t&> runner;
+      std::size_t count = 0;
+
+      for (const auto& rule : rules)
+      {
+        runner.add(rule, plorth::parser::ast::type_mask(rule.type()));
+      }
+      runner.run(*result, count);
+      assert(count == expected);
+    })
+  );
+}
@@ -25,52 +25,347 @@
  */
 #pragma once
 
+#include <optional>
+#include <type_traits>
+
 #include <peelo/result.hpp>
-#include <peelo/unicode/ctype/isvalid.hpp>
-#include <peelo/unicode/ctype/isxdigit.hpp>
 #include <plorth/parser/ast.hpp>
+#include <plorth/parser/builder.hpp>
 #include <plorth/parser/error.hpp>
+#include <plorth/parser/escape.hpp>
+#include <plorth/parser/utf8.hpp>
 #include <plorth/parser/utils.hpp>
 
 namespace plorth::parser
 {
-  using parse_result = peelo::result<
-    std::vector<std::shared_ptr<ast::token>>,
+  /**
+   * Contents of an string literal. When the string literal contains no
+   * escape sequences and the source code is stored in contiguous memory, the
+   * contents are given as a slice of the source code and the buffer is left
+   * empty.
+   */
+  struct string_literal
+  {
+    /** Contents of the string literal in the source code, if available. */
+    std::optional<std::u32string_view> slice;
+    /** Decoded contents of the string literal, if slice is not available. */
+    std::u32string buffer;
+    /** Whether the string literal contains escape sequences. */
+    bool escaped = false;
+  };
+
+  template<class BuilderT>
+  using basic_parse_result = peelo::result<
+    std::vector<typename BuilderT::token_type>,
     error
   >;
-  using parse_token_result = peelo::result<
-    std::shared_ptr<ast::token>,
+  template<class BuilderT>
+  using basic_parse_token_result = peelo::result<
+    typename BuilderT::token_type,
     error
   >;
-  using parse_array_result = peelo::result<
-    std::shared_ptr<ast::array>,
+  template<class BuilderT>
+  using basic_parse_array_result = peelo::result<
+    typename BuilderT::array_type,
     error
   >;
-  using parse_object_result = peelo::result<
-    std::shared_ptr<ast::object>,
+  template<class BuilderT>
+  using basic_parse_object_result = peelo::result<
+    typename BuilderT::object_type,
     error
   >;
-  using parse_quote_result = peelo::result<
-    std::shared_ptr<ast::quote>,
+  template<class BuilderT>
+  using basic_parse_quote_result = peelo::result<
+    typename BuilderT::quote_type,
     error
   >;
-  using parse_string_result = peelo::result<
-    std::shared_ptr<ast::string>,
+  template<class BuilderT>
+  using basic_parse_string_result = peelo::result<
+    typename BuilderT::string_type,
     error
   >;
-  using parse_word_result = peelo::result<
-    std::shared_ptr<ast::word>,
+  template<class BuilderT>
+  using basic_parse_word_result = peelo::result<
+    typename BuilderT::word_type,
     error
   >;
-  using parse_symbol_result = peelo::result<
-    std::shared_ptr<ast::symbol>,
+  template<class BuilderT>
+  using basic_parse_symbol_result = peelo::result<
+    typename BuilderT::symbol_type,
     error
   >;
-  using parse_escape_sequence_result = peelo::result<
-    char32_t,
+
+  using parse_result = basic_parse_result<ast::builder<>>;
+  using parse_token_result = basic_parse_token_result<ast::builder<>>;
+  using parse_array_result = basic_parse_array_result<ast::builder<>>;
+  using parse_object_result = basic_parse_object_result<ast::builder<>>;
+  using parse_quote_result = basic_parse_quote_result<ast::builder<>>;
+  using parse_string_result = basic_parse_string_result<ast::builder<>>;
+  using parse_word_result = basic_parse_word_result<ast::builder<>>;
+  using parse_symbol_result = basic_parse_symbol_result<ast::builder<>>;
+  using parse_string_literal_result = peelo::result<
+    string_literal,
     error
   >;
 
+  namespace internal
+  {
+    template<class BuilderT, class = void>
+    struct is_builder : std::false_type {};
+
+    template<class BuilderT>
+    struct is_builder<BuilderT, std::void_t<
+      typename BuilderT::token_type,
+      typename BuilderT::array_type,
+      typename BuilderT::object_type,
+      typename BuilderT::quote_type,
+      typename BuilderT::string_type,
+      typename BuilderT::symbol_type,
+      typename BuilderT::word_type,
+      typename BuilderT::array_container_type,
+      typename BuilderT::object_container_type,
+      typename BuilderT::quote_container_type,
+      decltype(std::declval<const BuilderT&>().make_array(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<typename BuilderT::array_container_type&&>()
+      )),
+      decltype(std::declval<const BuilderT&>().make_key(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<std::u32string&&>()
+      )),
+      decltype(std::declval<const BuilderT&>().make_object(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<typename BuilderT::object_container_type&&>()
+      )),
+      decltype(std::declval<const BuilderT&>().make_quote(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<typename BuilderT::quote_container_type&&>()
+      )),
+      decltype(std::declval<const BuilderT&>().make_string(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<std::u32string&&>()
+      )),
+      decltype(std::declval<const BuilderT&>().make_symbol(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<std::u32string&&>()
+      )),
+      decltype(std::declval<const BuilderT&>().make_word(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<typename BuilderT::symbol_type&&>()
+      ))
+    >> : std::conjunction<
+      std::is_convertible<
+        typename BuilderT::array_type,
+        typename BuilderT::token_type
+      >,
+      std::is_convertible<
+        typename BuilderT::object_type,
+        typename BuilderT::token_type
+      >,
+      std::is_convertible<
+        typename BuilderT::quote_type,
+        typename BuilderT::token_type
+      >,
+      std::is_convertible<
+        typename BuilderT::string_type,
+        typename BuilderT::token_type
+      >,
+      std::is_convertible<
+        typename BuilderT::symbol_type,
+        typename BuilderT::token_type
+      >,
+      std::is_convertible<
+        typename BuilderT::word_type,
+        typename BuilderT::token_type
+      >
+    > {};
+  }
+
+  /**
+   * Tells whether given type can be used as a builder by the parser
+   * functions. A builder provides the types of values it constructs
+   * (`token_type`, `array_type`, `object_type`, `quote_type`, `string_type`,
+   * `symbol_type` and `word_type`, each of which must be convertible into
+   * `token_type`), the containers in which it receives contents of arrays,
+   * objects and quotes (`array_container_type`, `object_container_type` and
+   * `quote_container_type`) and const member functions which construct the
+   * values:
+   *
+   * - `make_array(position, end, array_container_type&&)`
+   * - `make_key(position, end, std::u32string&&)`
+   * - `make_object(position, end, object_container_type&&)`
+   * - `make_quote(position, end, quote_container_type&&)`
+   * - `make_string(position, end, std::u32string&&)`
+   * - `make_symbol(position, end, std::u32string&&)`
+   * - `make_word(position, end, symbol_type&&)`
+   *
+   * Elements of `object_container_type` are constructed from a key returned
+   * by `make_key()` and a `token_type`. When the source code is parsed from
+   * contiguous memory, `make_key()`, `make_string()` and `make_symbol()`
+   * are given a `std::u32string_view` into the source code instead of a
+   * `std::u32string`, if possible, so a builder should accept both. A
+   * builder may also provide `reserve(container, const position*)`, which
+   * is called before a container is filled, and
+   * `make_lazy_quote(current, end, position)`, which is given the source
+   * code at the opening parenthesis of a quote and which consumes the quote
+   * instead of the parser, so that it's children can be parsed later.
+   * A builder which provides `deferred_escapes()` and
+   * `make_escaped_string(position, end, std::u32string_view)` is given
+   * string literals containing escape sequences undecoded, as slices of the
+   * source code, when the former returns true and the source code is stored
+   * in contiguous memory. The escape sequences have then already been
+   * checked to be valid.
+   */
+  template<class BuilderT>
+  inline constexpr bool is_builder_v = internal::is_builder<BuilderT>::value;
+
+  namespace internal
+  {
+    template<class BuilderT, class ContainerT, class = void>
+    struct has_reserve : std::false_type {};
+
+    template<class BuilderT, class ContainerT>
+    struct has_reserve<BuilderT, ContainerT, std::void_t<decltype(
+      std::declval<const BuilderT&>().reserve(
+        std::declval<ContainerT&>(),
+        std::declval<const struct position*>()
+      )
+    )>> : std::true_type {};
+
+    template<class BuilderT, class IteratorT, class = void>
+    struct has_lazy_quotes : std::false_type {};
+
+    template<class BuilderT, class IteratorT>
+    struct has_lazy_quotes<BuilderT, IteratorT, std::void_t<decltype(
+      std::declval<const BuilderT&>().make_lazy_quote(
+        std::declval<IteratorT&>(),
+        std::declval<const IteratorT&>(),
+        std::declval<struct position&>()
+      )
+    )>> : std::true_type {};
+
+    template<class BuilderT, class = void>
+    struct has_escaped_strings : std::false_type {};
+
+    template<class BuilderT>
+    struct has_escaped_strings<BuilderT, std::void_t<
+      decltype(std::declval<const BuilderT&>().deferred_escapes()),
+      decltype(std::declval<const BuilderT&>().make_escaped_string(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<const std::u32string_view&>()
+      ))
+    >> : std::true_type {};
+
+    /**
+     * Lets the builder reserve space in a container before it's filled, if
+     * the builder knows how many values the container will hold. Containers
+     * of arrays, objects and quotes are identified by their position, while
+     * container of top level values is given without one.
+     */
+    template<class BuilderT, class ContainerT>
+    inline void reserve(
+      const BuilderT& builder,
+      ContainerT& container,
+      const struct position* position = nullptr
+    )
+    {
+      if constexpr (has_reserve<BuilderT, ContainerT>::value)
+      {
+        builder.reserve(container, position);
+      }
+    }
+
+    template<class IteratorT, class BuilderT>
+    inline auto make_key(
+      const BuilderT& builder,
+      const struct position& position,
+      std::uint64_t end,
+      string_literal&& literal
+    )
+    {
+      if constexpr (utils::is_contiguous_v<IteratorT>)
+      {
+        if (literal.slice)
+        {
+          return builder.make_key(position, end, *literal.slice);
+        }
+      }
+
+      return builder.make_key(position, end, std::move(literal.buffer));
+    }
+
+    template<class IteratorT, class BuilderT>
+    inline auto make_string(
+      const BuilderT& builder,
+      const struct position& position,
+      std::uint64_t end,
+      string_literal&& literal
+    )
+    {
+      if constexpr (utils::is_contiguous_v<IteratorT>)
+      {
+        if (literal.slice)
+        {
+          return builder.make_string(position, end, *literal.slice);
+        }
+      }
+
+      return builder.make_string(position, end, std::move(literal.buffer));
+    }
+
+    template<class IteratorT, class BuilderT>
+    inline auto make_symbol(
+      const BuilderT& builder,
+      const struct position& position,
+      std::uint64_t end,
+      string_literal&& literal
+    )
+    {
+      if constexpr (utils::is_contiguous_v<IteratorT>)
+      {
+        if (literal.slice)
+        {
+          return builder.make_symbol(position, end, *literal.slice);
+        }
+      }
+
+      return builder.make_symbol(position, end, std::move(literal.buffer));
+    }
+
+    template<class IteratorT, class BuilderT>
+    inline auto make_symbol(
+      const BuilderT& builder,
+      const struct position& position,
+      std::uint64_t end,
+      const IteratorT& begin,
+      const IteratorT& current
+    )
+    {
+      if constexpr (utils::is_contiguous_v<IteratorT>)
+      {
+        return builder.make_symbol(
+          position,
+          end,
+          utils::slice(begin, current)
+        );
+      } else {
+        return builder.make_symbol(
+          position,
+          end,
+          std::u32string(begin, current)
+        );
+      }
+    }
+  }
+
   /**
    * Attempts to parse an entire Plorth program and returns the AST tokens
    * encountered in the source code in an vector.
@@ -78,28 +373,61 @@ namespace plorth::parser
    * \param current  Iterator pointing to current position in source code.
    * \param end      Iterator pointing to end of the source code.
    * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
    */
-  template<class IteratorT>
-  parse_result parse(
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_result<BuilderT> parse(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    const BuilderT& builder = BuilderT()
   )
   {
-    std::vector<std::shared_ptr<ast::token>> tokens;
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    using result_type = basic_parse_result<BuilderT>;
+    std::vector<typename BuilderT::token_type> tokens;
+
+    internal::reserve(builder, tokens);
 
     while (current < end)
     {
-      const auto token_result = parse_token(current, end, position);
+      auto token_result = parse_token(current, end, position, builder);
 
       if (!token_result)
       {
-        return parse_result::error(token_result.error());
+        return result_type::error(token_result.error());
       }
-      tokens.push_back(*token_result);
+      tokens.push_back(std::move(*token_result));
     }
 
-    return parse_result::ok(tokens);
+    return result_type::ok(std::move(tokens));
+  }
+
+  /**
+   * Attempts to parse an entire Plorth program from UTF-8 encoded source code
+   * and returns the AST tokens encountered in the source code in an vector.
+   *
+   * The source code is decoded on the fly, so there is no need to convert it
+   * into UTF-32 before parsing.
+   *
+   * \param source   UTF-8 encoded source code.
+   * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
+   */
+  template<class BuilderT = ast::builder<>>
+  basic_parse_result<BuilderT> parse(
+    const std::string_view& source,
+    struct position& position,
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    auto current = utf8::begin(source);
+    const auto end = utf8::end(source);
+
+    return parse(current, end, position, builder);
   }
 
   /**
@@ -108,17 +436,25 @@ namespace plorth::parser
    * \param current  Iterator pointing to current position in source code.
    * \param end      Iterator pointing to end of the source code.
    * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
    */
-  template<class IteratorT>
-  parse_token_result parse_token(
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_token_result<BuilderT> parse_token(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    const BuilderT& builder = BuilderT()
   )
   {
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    using result_type = basic_parse_token_result<BuilderT>;
+
     if (utils::skip_whitespace(current, end, position))
     {
-      return parse_token_result::error({
+      return result_type::error({
         position,
         U"Unexpected end of input; Missing value."
       });
@@ -127,20 +463,20 @@ namespace plorth::parser
     switch (*current)
     {
       case '[':
-        return parse_array(current, end, position);
+        return parse_array(current, end, position, builder);
 
       case '{':
-        return parse_object(current, end, position);
+        return parse_object(current, end, position, builder);
 
       case '(':
-        return parse_quote(current, end, position);
+        return parse_quote(current, end, position, builder);
 
       case '"':
       case '\'':
-        return parse_string(current, end, position);
+        return parse_string(current, end, position, builder);
     }
 
-    return parse_symbol_or_word(current, end, position);
+    return parse_symbol_or_word(current, end, position, builder);
   }
 
   /**
@@ -149,20 +485,23 @@ namespace plorth::parser
    * \param current  Iterator pointing to current position in source code.
    * \param end      Iterator pointing to end of the source code.
    * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
    */
-  template<class IteratorT>
-  parse_array_result parse_array(
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_array_result<BuilderT> parse_array(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    const BuilderT& builder = BuilderT()
   )
   {
+    using result_type = basic_parse_array_result<BuilderT>;
     struct position array_position = position;
-    ast::array::container_type elements;
+    typename BuilderT::array_container_type elements;
 
     if (utils::skip_whitespace(current, end, position))
     {
-      return parse_array_result::error({
+      return result_type::error({
         array_position,
         U"Unexpected end of input; Missing array."
       });
@@ -170,17 +509,19 @@ namespace plorth::parser
 
     if (!utils::peek_advance(current, end, position, U'['))
     {
-      return parse_array_result::error({
+      return result_type::error({
         array_position,
         U"Unexpected input; Missing array."
       });
     }
 
+    internal::reserve(builder, elements, &array_position);
+
     for (;;)
     {
       if (utils::skip_whitespace(current, end, position))
       {
-        return parse_array_result::error({
+        return result_type::error({
           array_position,
           U"Unterminated array; Missing `]'."
         });
@@ -189,29 +530,33 @@ namespace plorth::parser
       {
         break;
       } else {
-        const auto value_result = parse_token(current, end, position);
+        auto value_result = parse_token(current, end, position, builder);
 
         if (value_result)
         {
-          elements.push_back(*value_result);
+          elements.push_back(std::move(*value_result));
           if (utils::skip_whitespace(current, end, position)
               || (!utils::peek(current, end, U',')
                 && !utils::peek(current, end, U']')))
           {
-            return parse_array_result::error({
+            return result_type::error({
               array_position,
               U"Unterminated array; Missing `]'."
             });
           }
           utils::peek_advance(current, end, position, U',');
         } else {
-          return parse_array_result::error(value_result.error());
+          return result_type::error(value_result.error());
         }
       }
     }
 
-    return parse_array_result::ok(
-      std::make_shared<ast::array>(array_position, elements)
+    return result_type::ok(
+      builder.make_array(
+        array_position,
+        position.offset,
+        std::move(elements)
+      )
     );
   }
 
@@ -221,20 +566,23 @@ namespace plorth::parser
    * \param current  Iterator pointing to current position in source code.
    * \param end      Iterator pointing to end of the source code.
    * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
    */
-  template<class IteratorT>
-  parse_object_result parse_object(
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_object_result<BuilderT> parse_object(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    const BuilderT& builder = BuilderT()
   )
   {
+    using result_type = basic_parse_object_result<BuilderT>;
     struct position object_position;
-    ast::object::container_type properties;
+    typename BuilderT::object_container_type properties;
 
     if (utils::skip_whitespace(current, end, position))
     {
-      return parse_object_result::error({
+      return result_type::error({
         position,
         U"Unexpected end of input; Missing object."
       });
@@ -244,17 +592,19 @@ namespace plorth::parser
 
     if (!utils::peek_advance(current, end, position, U'{'))
     {
-      return parse_object_result::error({
+      return result_type::error({
         object_position,
         U"Unexpected input; Missing object."
       });
     }
 
+    internal::reserve(builder, properties, &object_position);
+
     for (;;)
     {
       if (utils::skip_whitespace(current, end, position))
       {
-        return parse_object_result::error({
+        return result_type::error({
           object_position,
           U"Unterminated object; Missing `}'."
         });
@@ -264,45 +614,58 @@ namespace plorth::parser
         break;
       }
 
-      const auto key_result = parse_string(current, end, position);
+      struct position key_position;
+      auto key_result = parse_string_literal(
+        current,
+        end,
+        position,
+        key_position
+      );
 
       if (!key_result)
       {
-        return parse_object_result::error(key_result.error());
+        return result_type::error(key_result.error());
       }
 
+      const auto key_end = position.offset;
+
       if (utils::skip_whitespace(current, end, position))
       {
-        return parse_object_result::error({
+        return result_type::error({
           object_position,
           U"Unterminated object; Missing `:'."
         });
       }
       else if (!utils::peek_advance(current, end, position, U':'))
       {
-        return parse_object_result::error({
+        return result_type::error({
           object_position,
           U"Missing `:' after property key."
         });
       }
 
-      const auto value_result = parse_token(current, end, position);
+      auto value_result = parse_token(current, end, position, builder);
 
       if (!value_result)
       {
-        return parse_object_result::error(value_result.error());
+        return result_type::error(value_result.error());
       }
 
-      properties.push_back(std::make_pair(
-        (*key_result)->value(),
-        *value_result
-      ));
+      properties.emplace_back(
+        internal::make_key<IteratorT>(
+          builder,
+          key_position,
+          key_end,
+          std::move(*key_result)
+        ),
+        std::move(*value_result)
+      );
 
       if (utils::skip_whitespace(current, end, position)
           || (!utils::peek(current, end, U',')
             && !utils::peek(current, end, U'}')))
       {
-        return parse_object_result::error({
+        return result_type::error({
           object_position,
           U"Unterminated object; Missing `}'."
         });
@@ -311,8 +674,12 @@ namespace plorth::parser
       utils::peek_advance(current, end, position, U',');
     }
 
-    return parse_object_result::ok(
-      std::make_shared<ast::object>(object_position, properties)
+    return result_type::ok(
+      builder.make_object(
+        object_position,
+        position.offset,
+        std::move(properties)
+      )
     );
   }
 
@@ -322,20 +689,23 @@ namespace plorth::parser
    * \param current  Iterator pointing to current position in source code.
    * \param end      Iterator pointing to end of the source code.
    * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
    */
-  template<class IteratorT>
-  parse_quote_result parse_quote(
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_quote_result<BuilderT> parse_quote(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    const BuilderT& builder = BuilderT()
   )
   {
+    using result_type = basic_parse_quote_result<BuilderT>;
     struct position quote_position;
-    ast::quote::container_type children;
+    typename BuilderT::quote_container_type children;
 
     if (utils::skip_whitespace(current, end, position))
     {
-      return parse_quote_result::error({
+      return result_type::error({
         position,
         U"Unexpected end of input; Missing quote."
       });
@@ -343,19 +713,29 @@ namespace plorth::parser
 
     quote_position = position;
 
+    if constexpr (internal::has_lazy_quotes<BuilderT, IteratorT>::value)
+    {
+      if (utils::peek(current, end, U'('))
+      {
+        return builder.make_lazy_quote(current, end, position);
+      }
+    }
+
     if (!utils::peek_advance(current, end, position, U'('))
     {
-      return parse_quote_result::error({
+      return result_type::error({
         quote_position,
         U"Unexpected input; Missing quote."
       });
     }
 
+    internal::reserve(builder, children, &quote_position);
+
     for (;;)
     {
       if (utils::skip_whitespace(current, end, position))
       {
-        return parse_quote_result::error({
+        return result_type::error({
           quote_position,
           U"Unterminated quote; Missing `)'."
         });
@@ -364,220 +744,275 @@ namespace plorth::parser
       {
         break;
       } else {
-        const auto child_result = parse_token(current, end, position);
+        auto child_result = parse_token(current, end, position, builder);
 
         if (child_result)
         {
-          children.push_back(*child_result);
+          children.push_back(std::move(*child_result));
         } else {
-          return parse_quote_result::error(child_result.error());
+          return result_type::error(child_result.error());
         }
       }
     }
 
-    return parse_quote_result::ok(
-      std::make_shared<ast::quote>(quote_position, children)
+    return result_type::ok(
+      builder.make_quote(
+        quote_position,
+        position.offset,
+        std::move(children)
+      )
     );
   }
 
-  /**
-   * Attempts to parse string literal escape sequence.
-   *
-   * \param current  Iterator pointing to current position in source code.
-   * \param end      Iterator pointing to end of the source code.
-   * \param position Current source code position.
-   */
-  template<class IteratorT>
-  parse_escape_sequence_result parse_escape_sequence(
-    IteratorT& current,
-    const IteratorT& end,
-    struct position& position
-  )
+  namespace internal
   {
-    char32_t result;
-
-    if (current >= end)
-    {
-      return parse_escape_sequence_result::error({
-        position,
-        U"Unexpected end of input; Missing escape sequence."
-      });
-    }
-
-    if (!utils::peek_advance(current, end, position, U'\\'))
-    {
-      return parse_escape_sequence_result::error({
-        position,
-        U"Unexpected input; Missing escape sequence."
-      });
-    }
-
-    if (current >= end)
-    {
-      return parse_escape_sequence_result::error({
-        position,
-        U"Unexpected end of input; Missing escape sequence."
-      });
-    }
-
-    switch (utils::advance(current, position))
+    /**
+     * Parses contents of string literal into given structure, reusing
+     * memory already allocated by it's buffer. Returns an error if the
+     * string literal could not be parsed. If decoding is disabled, escape
+     * sequences are only checked for errors, and the structure receives the
+     * undecoded contents as a slice of the source code if the source code is
+     * stored in contiguous memory.
+     */
+    template<class IteratorT, bool Decode = true>
+    std::optional<error> parse_string_literal(
+      IteratorT& current,
+      const IteratorT& end,
+      struct position& position,
+      struct position& string_position,
+      string_literal& literal
+    )
     {
-      case 'b':
-        result = 010;
-        break;
+      char32_t separator;
+      bool escaped = false;
 
-      case 't':
-        result = 011;
-        break;
+      literal.slice.reset();
+      literal.buffer.clear();
+      literal.escaped = false;
 
-      case 'n':
-        result = 012;
-        break;
+      if (utils::skip_whitespace(current, end, position))
+      {
+        return error({
+          position,
+          U"Unexpected end of input; Missing string."
+        });
+      }
 
-      case 'f':
-        result = 014;
-        break;
+      string_position = position;
 
-      case 'r':
-        result = 015;
-        break;
+      if (utils::peek_advance(current, end, position, U'"'))
+      {
+        separator = U'"';
+      }
+      else if (utils::peek_advance(current, end, position, U'\''))
+      {
+        separator = U'\'';
+      } else {
+        return error({
+          string_position,
+          U"Unexpected input; Missing string."
+        });
+      }
 
-      case '"':
-      case '\'':
-      case '\\':
-      case '/':
-        result = *(current - 1);
-        break;
+      const auto begin = current;
 
-      case 'u':
-        result = 0;
-        for (int i = 0; i < 4; ++i)
+      for (;;)
+      {
+        if (current >= end)
         {
-          if (current >= end)
+          return error({
+            string_position,
+            std::u32string(U"Unterminated string; Missing `")
+            + separator
+            + U"'."
+          });
+        }
+        else if (utils::peek(current, end, separator))
+        {
+          if constexpr (utils::is_contiguous_v<IteratorT>)
           {
-            return parse_escape_sequence_result::error({
-              position,
-              U"Unterminated escape sequence."
-            });
+            if (!Decode || !escaped)
+            {
+              literal.slice = utils::slice(begin, current);
+            }
           }
-          else if (!peelo::unicode::ctype::isxdigit(*current))
+          else if (Decode && !escaped)
           {
-            return parse_escape_sequence_result::error({
-              position,
-              U"Illegal Unicode hex escape sequence."
-            });
+            literal.buffer.assign(begin, current);
+          }
+          literal.escaped = escaped;
+          utils::advance(current, position);
+          break;
+        }
+        else if (utils::peek(current, end, U'\\'))
+        {
+          if (Decode && !escaped)
+          {
+            literal.buffer.assign(begin, current);
           }
+          escaped = true;
 
-          if (*current >= 'A' && *current <= 'F')
+          const auto escape_sequence_result = parse_escape_sequence(
+            current,
+            end,
+            position
+          );
+
+          if (!escape_sequence_result)
           {
-            result = result * 16 + (*current - 'A' + 10);
+            return escape_sequence_result.error();
           }
-          else if (*current >= 'a' && *current <= 'f')
+          else if (Decode)
           {
-            result = result * 16 + (*current - 'a' + 10);
-          } else {
-            result = result * 16 + (*current - '0');
+            literal.buffer.append(1, *escape_sequence_result);
           }
+        } else {
+          const auto run = current;
 
-          utils::advance(current, position);
-        }
-
-        if (!peelo::unicode::ctype::isvalid(result))
-        {
-          return parse_escape_sequence_result::error({
+          if (utils::advance_run(
+            current,
+            end,
             position,
-            U"Illegal Unicode hex escape sequence."
-          });
+            [separator](const char32_t* first, const char32_t* last)
+            {
+              return scan::find_string_delimiter(first, last, separator);
+            },
+            [separator](const char* first, const char* last)
+            {
+              return scan::ascii::find_string_delimiter(
+                first,
+                last,
+                separator
+              );
+            }
+          ))
+          {
+            if (Decode && escaped)
+            {
+              literal.buffer.append(run, current);
+            }
+            continue;
+          }
+
+          const auto c = utils::advance(current, position);
+
+          if (Decode && escaped)
+          {
+            literal.buffer.append(1, c);
+          }
         }
-        break;
+      }
 
-      default:
-        return parse_escape_sequence_result::error({
-          position,
-          U"Illegal escape sequence in string literal."
-        });
+      return std::nullopt;
     }
-
-    return parse_escape_sequence_result::ok(result);
   }
 
   /**
-   * Attempts to parse string literal AST token.
+   * Attempts to parse contents of string literal, without constructing an
+   * AST token from it. Contents of the string literal are copied only if the
+   * source code is not stored in contiguous memory, or if the string literal
+   * contains escape sequences.
    *
-   * \param current  Iterator pointing to current position in source code.
-   * \param end      Iterator pointing to end of the source code.
-   * \param position Current source code position.
+   * \param current         Iterator pointing to current position in source
+   *                        code.
+   * \param end             Iterator pointing to end of the source code.
+   * \param position        Current source code position.
+   * \param string_position Receives position of the string literal.
    */
   template<class IteratorT>
-  parse_string_result parse_string(
+  parse_string_literal_result parse_string_literal(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    struct position& string_position
   )
   {
-    struct position string_position;
-    char32_t separator;
-    std::u32string buffer;
+    string_literal literal;
+    auto literal_error = internal::parse_string_literal(
+      current,
+      end,
+      position,
+      string_position,
+      literal
+    );
 
-    if (utils::skip_whitespace(current, end, position))
+    if (literal_error)
     {
-      return parse_string_result::error({
-        position,
-        U"Unexpected end of input; Missing string."
-      });
+      return parse_string_literal_result::error(std::move(*literal_error));
     }
 
-    string_position = position;
+    return parse_string_literal_result::ok(std::move(literal));
+  }
 
-    if (utils::peek_advance(current, end, position, U'"'))
-    {
-      separator = U'"';
-    }
-    else if (utils::peek_advance(current, end, position, U'\''))
-    {
-      separator = U'\'';
-    } else {
-      return parse_string_result::error({
-        string_position,
-        U"Unexpected input; Missing string."
-      });
-    }
+  /**
+   * Attempts to parse string literal AST token.
+   *
+   * \param current  Iterator pointing to current position in source code.
+   * \param end      Iterator pointing to end of the source code.
+   * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
+   */
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_string_result<BuilderT> parse_string(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position,
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    using result_type = basic_parse_string_result<BuilderT>;
+    struct position string_position;
 
-    for (;;)
+    if constexpr (utils::is_contiguous_v<IteratorT>
+        && internal::has_escaped_strings<BuilderT>::value)
     {
-      if (current >= end)
+      if (builder.deferred_escapes())
       {
-        return parse_string_result::error({
-          string_position,
-          std::u32string(U"Unterminated string; Missing `")
-          + separator
-          + U"'."
-        });
-      }
-      else if (utils::peek_advance(current, end, position, separator))
-      {
-        break;
-      }
-      else if (utils::peek(current, end, U'\\'))
-      {
-        const auto escape_sequence_result = parse_escape_sequence(
-          current,
-          end,
-          position
-        );
+        string_literal literal;
 
-        if (!escape_sequence_result)
+        if (auto literal_error = internal::parse_string_literal<
+          IteratorT,
+          false
+        >(current, end, position, string_position, literal))
         {
-          return parse_string_result::error(escape_sequence_result.error());
+          return result_type::error(std::move(*literal_error));
         }
-        buffer.append(1, *escape_sequence_result);
-      } else {
-        buffer.append(1, utils::advance(current, position));
+        else if (literal.escaped)
+        {
+          return result_type::ok(builder.make_escaped_string(
+            string_position,
+            position.offset,
+            *literal.slice
+          ));
+        }
+
+        return result_type::ok(builder.make_string(
+          string_position,
+          position.offset,
+          *literal.slice
+        ));
       }
     }
 
-    return parse_string_result::ok(
-      std::make_shared<ast::string>(string_position, buffer)
+    auto value_result = parse_string_literal(
+      current,
+      end,
+      position,
+      string_position
+    );
+
+    if (!value_result)
+    {
+      return result_type::error(value_result.error());
+    }
+
+    return result_type::ok(
+      internal::make_string<IteratorT>(
+        builder,
+        string_position,
+        position.offset,
+        std::move(*value_result)
+      )
     );
   }
 
@@ -587,20 +1022,22 @@ namespace plorth::parser
    * \param current  Iterator pointing to current position in source code.
    * \param end      Iterator pointing to end of the source code.
    * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
    */
-  template<class IteratorT>
-  parse_symbol_result parse_symbol(
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_symbol_result<BuilderT> parse_symbol(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    const BuilderT& builder = BuilderT()
   )
   {
+    using result_type = basic_parse_symbol_result<BuilderT>;
     struct position symbol_position;
-    std::u32string buffer;
 
     if (utils::skip_whitespace(current, end, position))
     {
-      return parse_symbol_result::error({
+      return result_type::error({
         position,
         U"Unexpected end of input; Missing symbol."
       });
@@ -610,20 +1047,35 @@ namespace plorth::parser
 
     if (!utils::isword(*current))
     {
-      return parse_symbol_result::error({
+      return result_type::error({
         symbol_position,
         U"Unexpected input; Missing symbol."
       });
     }
 
+    const auto begin = current;
+
     do
     {
-      buffer.append(1, utils::advance(current, position));
+      utils::advance(current, position);
+      utils::advance_run(
+        current,
+        end,
+        position,
+        scan::skip_word,
+        scan::ascii::skip_word
+      );
     }
     while (current < end && utils::isword(*current));
 
-    return parse_symbol_result::ok(
-      std::make_shared<ast::symbol>(symbol_position, buffer)
+    return result_type::ok(
+      internal::make_symbol(
+        builder,
+        symbol_position,
+        position.offset,
+        begin,
+        current
+      )
     );
   }
 
@@ -633,20 +1085,22 @@ namespace plorth::parser
    * \param current  Iterator pointing to current position in source code.
    * \param end      Iterator pointing to end of the source code.
    * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
    */
-  template<class IteratorT>
-  parse_token_result parse_symbol_or_word(
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_token_result<BuilderT> parse_symbol_or_word(
     IteratorT& current,
     const IteratorT& end,
-    struct position& position
+    struct position& position,
+    const BuilderT& builder = BuilderT()
   )
   {
+    using result_type = basic_parse_token_result<BuilderT>;
     struct position symbol_or_word_position;
-    std::u32string buffer;
 
     if (utils::skip_whitespace(current, end, position))
     {
-      return parse_symbol_result::error({
+      return result_type::error({
         position,
         U"Unexpected end of input; Missing symbol or word definition."
       });
@@ -656,41 +1110,53 @@ namespace plorth::parser
 
     if (!utils::isword(*current))
     {
-      return parse_symbol_result::error({
+      return result_type::error({
         symbol_or_word_position,
         U"Unexpected input; Missing symbol or word definition."
       });
     }
 
+    const auto begin = current;
+
     do
     {
-      buffer.append(1, utils::advance(current, position));
+      utils::advance(current, position);
+      utils::advance_run(
+        current,
+        end,
+        position,
+        scan::skip_word,
+        scan::ascii::skip_word
+      );
     }
     while (current < end && utils::isword(*current));
 
-    if (!buffer.compare(U"->"))
+    if (utils::equals(begin, current, U"->"))
     {
-      const auto symbol_result = parse_symbol(
-        current,
-        end,
-        symbol_or_word_position
-      );
+      auto symbol_result = parse_symbol(current, end, position, builder);
 
       if (!symbol_result)
       {
-        return parse_token_result::error(symbol_result.error());
+        return result_type::error(symbol_result.error());
       }
 
-      return parse_token_result::ok(
-        std::make_shared<ast::word>(
+      return result_type::ok(
+        builder.make_word(
           symbol_or_word_position,
-          *symbol_result
+          position.offset,
+          std::move(*symbol_result)
         )
       );
     }
 
-    return parse_token_result::ok(
-      std::make_shared<ast::symbol>(symbol_or_word_position, buffer)
+    return result_type::ok(
+      internal::make_symbol(
+        builder,
+        symbol_or_word_position,
+        position.offset,
+        begin,
+        current
+      )
     );
   }
 }
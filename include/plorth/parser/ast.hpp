@@ -25,13 +25,58 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include <plorth/parser/escape.hpp>
+#include <plorth/parser/interned_string.hpp>
 #include <plorth/parser/position.hpp>
 
 namespace plorth::parser::ast
 {
+  /**
+   * Tag type used to select constructors of string literal and symbol tokens
+   * which refer directly to the source code, instead of owning a copy of
+   * their contents.
+   */
+  struct source_view_t
+  {
+    explicit source_view_t() = default;
+  };
+
+  /**
+   * Tag value used to select constructors of string literal and symbol
+   * tokens which refer directly to the source code.
+   */
+  inline constexpr source_view_t source_view{};
+
+  /**
+   * Tag type used to select the constructor of string literal tokens which
+   * refer to contents of a string literal containing escape sequences in the
+   * source code, and decode them only when the contents are first accessed.
+   */
+  struct escaped_source_view_t
+  {
+    explicit escaped_source_view_t() = default;
+  };
+
+  /**
+   * Tag value used to select the constructor of string literal tokens which
+   * decode escape sequences only when their contents are first accessed.
+   */
+  inline constexpr escaped_source_view_t escaped_source_view{};
+
+  namespace internal
+  {
+    struct position_shift;
+    struct teardown;
+  }
+
   /**
    * Abstract base class for various elements that might appear in source code
    * of Plorth program.
@@ -62,9 +107,12 @@ namespace plorth::parser::ast
      * Base constructor for an token.
      *
      * \param position Position in source code where the token was found from.
+     * \param end      Offset in source code where the token ends, or zero if
+     *                 it's not known.
      */
-    explicit token(const struct position& position)
-      : m_position(position) {}
+    explicit token(const struct position& position, std::uint64_t end = 0)
+      : m_position(position)
+      , m_end(end) {}
 
     virtual ~token() {}
 
@@ -76,6 +124,19 @@ namespace plorth::parser::ast
       return m_position;
     }
 
+    /**
+     * Returns the range of source code the token was parsed from, as offsets
+     * from beginning of the source code. If end of the token is not known,
+     * the range is empty.
+     */
+    inline source_span span() const
+    {
+      return {
+        m_position.offset,
+        m_end > m_position.offset ? m_end : m_position.offset
+      };
+    }
+
     /**
      * Returns type of the token.
      */
@@ -87,8 +148,16 @@ namespace plorth::parser::ast
     void operator=(token&&) = delete;
 
   private:
-    /** Position in source code where the token was found from. */
-    const struct position m_position;
+    friend struct internal::position_shift;
+
+    /**
+     * Position in source code where the token was found from. Only changed
+     * when the source code is edited before the token, as the token is
+     * reused by reparse().
+     */
+    struct position m_position;
+    /** Offset in source code where the token ends. */
+    std::uint64_t m_end;
   };
 
   /**
@@ -101,11 +170,22 @@ namespace plorth::parser::ast
 
     explicit array(
       const struct position& position,
-      const container_type& elements
+      const container_type& elements,
+      std::uint64_t end = 0
     )
-      : token(position)
+      : token(position, end)
       , m_elements(elements) {}
 
+    explicit array(
+      const struct position& position,
+      container_type&& elements,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
+      , m_elements(std::move(elements)) {}
+
+    ~array();
+
     inline enum type type() const
     {
       return type::array;
@@ -120,6 +200,8 @@ namespace plorth::parser::ast
     }
 
   private:
+    friend struct internal::teardown;
+
     /** Elements of the array. */
     const container_type m_elements;
   };
@@ -130,18 +212,29 @@ namespace plorth::parser::ast
   class object : public token
   {
   public:
-    using key_type = std::u32string;
+    using key_type = interned_string;
     using mapped_type = std::shared_ptr<token>;
     using value_type = std::pair<key_type, mapped_type>;
     using container_type = std::vector<value_type>;
 
     explicit object(
       const struct position& position,
-      const container_type& properties
+      const container_type& properties,
+      std::uint64_t end = 0
     )
-      : token(position)
+      : token(position, end)
       , m_properties(properties) {}
 
+    explicit object(
+      const struct position& position,
+      container_type&& properties,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
+      , m_properties(std::move(properties)) {}
+
+    ~object();
+
     inline enum type type() const
     {
       return type::object;
@@ -156,6 +249,8 @@ namespace plorth::parser::ast
     }
 
   private:
+    friend struct internal::teardown;
+
     /** Properties of the object. */
     const container_type m_properties;
   };
@@ -170,27 +265,103 @@ namespace plorth::parser::ast
 
     explicit quote(
       const struct position& position,
-      const container_type& children
+      const container_type& children,
+      std::uint64_t end = 0
     )
-      : token(position)
+      : token(position, end)
       , m_children(children) {}
 
+    explicit quote(
+      const struct position& position,
+      container_type&& children,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
+      , m_children(std::move(children)) {}
+
+    ~quote();
+
     inline enum type type() const
     {
       return type::quote;
     }
 
     /**
-     * Returns child tokens of the quote.
+     * Returns child tokens of the quote. If the quote is lazy, the children
+     * are parsed when this method is called for the first time.
      */
-    inline const container_type& children() const
+    virtual const container_type& children() const
     {
       return m_children;
     }
 
+    /**
+     * Returns true if children of the quote are parsed from the source code
+     * only when they are accessed for the first time.
+     */
+    virtual bool is_lazy() const
+    {
+      return false;
+    }
+
+  protected:
+    explicit quote(const struct position& position, std::uint64_t end)
+      : token(position, end) {}
+
+    /** Child tokens of the quote, once they have been parsed. */
+    mutable container_type m_children;
+
   private:
-    /** Child tokens of the quote. */
-    const container_type m_children;
+    friend struct internal::teardown;
+  };
+
+  /**
+   * Quote literal whose children are parsed from the source code only when
+   * they are accessed for the first time.
+   */
+  class lazy_quote final : public quote
+  {
+  public:
+    using loader_type = std::function<container_type()>;
+
+    /**
+     * Constructs lazy quote. The source code must outlive the token.
+     *
+     * \param position Position in source code where the token was found from.
+     * \param loader   Function which parses the children from the source
+     *                 code.
+     * \param end      Offset in source code where the token ends, or zero if
+     *                 it's not known.
+     */
+    explicit lazy_quote(
+      const struct position& position,
+      loader_type&& loader,
+      std::uint64_t end = 0
+    )
+      : quote(position, end)
+      , m_loader(std::move(loader)) {}
+
+    const container_type& children() const override
+    {
+      std::call_once(m_loaded, [this]()
+      {
+        m_children = m_loader();
+        m_loader = nullptr;
+      });
+
+      return m_children;
+    }
+
+    bool is_lazy() const override
+    {
+      return true;
+    }
+
+  private:
+    /** Function which parses the children, until it has been called. */
+    mutable loader_type m_loader;
+    /** Used to parse the children only once. */
+    mutable std::once_flag m_loaded;
   };
 
   /**
@@ -201,26 +372,166 @@ namespace plorth::parser::ast
   public:
     using value_type = std::u32string;
 
-    explicit string(const struct position& position, const value_type& value)
-      : token(position)
+    explicit string(
+      const struct position& position,
+      const value_type& value,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
       , m_value(value) {}
 
+    explicit string(
+      const struct position& position,
+      value_type&& value,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
+      , m_value(std::move(value)) {}
+
     inline enum type type() const
     {
       return type::string;
     }
 
     /**
-     * Returns text contents of the string literal.
+     * Returns text contents of the string literal. If the string literal
+     * refers to the source code, a copy of it's contents is made, and escape
+     * sequences in them are decoded, when this method is called for the
+     * first time.
+     */
+    virtual const value_type& value() const
+    {
+      return m_value;
+    }
+
+    /**
+     * Returns text contents of the string literal without copying them,
+     * unless escape sequences in them have to be decoded first.
+     */
+    virtual std::u32string_view view() const
+    {
+      return m_value;
+    }
+
+    /**
+     * Returns true if the string literal refers directly to the source code
+     * instead of owning a copy of it's contents.
      */
-    inline const value_type& value() const
+    virtual bool is_source_view() const
     {
+      return false;
+    }
+
+    /**
+     * Returns true if the string literal refers to contents of the source
+     * code containing escape sequences, which are decoded when the contents
+     * are first accessed.
+     */
+    virtual bool has_escapes() const
+    {
+      return false;
+    }
+
+  protected:
+    explicit string(const struct position& position, std::uint64_t end)
+      : token(position, end) {}
+
+    /** Text contents of the string literal, once they have been copied. */
+    mutable value_type m_value;
+  };
+
+  /**
+   * String literal which refers to it's contents in the source code instead
+   * of owning a copy of them, until the contents are first accessed through
+   * value().
+   */
+  class source_string final : public string
+  {
+  public:
+    /**
+     * Constructs string literal which refers directly to contents of the
+     * source code. The source code must outlive the token.
+     *
+     * \param position Position in source code where the token was found from.
+     * \param view     Contents of the string literal in the source code.
+     * \param end      Offset in source code where the token ends, or zero if
+     *                 it's not known.
+     */
+    explicit source_string(
+      const struct position& position,
+      source_view_t,
+      const std::u32string_view& view,
+      std::uint64_t end = 0
+    )
+      : string(position, end)
+      , m_view(view)
+      , m_escaped(false) {}
+
+    /**
+     * Constructs string literal which refers to contents of the source code
+     * containing escape sequences, which are decoded when contents of the
+     * string literal are accessed for the first time. The escape sequences
+     * must already have been checked to be valid. The source code must
+     * outlive the token.
+     *
+     * \param position Position in source code where the token was found from.
+     * \param source   Contents of the string literal in the source code,
+     *                 without the surrounding quotes.
+     * \param end      Offset in source code where the token ends, or zero if
+     *                 it's not known.
+     */
+    explicit source_string(
+      const struct position& position,
+      escaped_source_view_t,
+      const std::u32string_view& source,
+      std::uint64_t end = 0
+    )
+      : string(position, end)
+      , m_view(source)
+      , m_escaped(true) {}
+
+    const value_type& value() const override
+    {
+      std::call_once(m_materialized, [this]()
+      {
+        if (m_escaped)
+        {
+          m_value = decode_escape_sequences(m_view);
+        } else {
+          m_value.assign(m_view);
+        }
+      });
+
       return m_value;
     }
 
+    std::u32string_view view() const override
+    {
+      if (m_escaped)
+      {
+        return value();
+      }
+
+      return m_view;
+    }
+
+    bool is_source_view() const override
+    {
+      return true;
+    }
+
+    bool has_escapes() const override
+    {
+      return m_escaped;
+    }
+
   private:
-    /** Text contents of the string literal. */
-    const value_type m_value;
+    /** Contents of the string literal in the source code. */
+    const std::u32string_view m_view;
+    /** Whether escape sequences are decoded on first access. */
+    const bool m_escaped;
+    /** Used to copy contents of the source code only once. */
+    mutable std::once_flag m_materialized;
   };
 
   /**
@@ -229,11 +540,47 @@ namespace plorth::parser::ast
   class symbol : public token
   {
   public:
-    using id_type = std::u32string;
+    using id_type = interned_string;
+
+    explicit symbol(
+      const struct position& position,
+      const id_type& id,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
+      , m_id(id)
+      , m_view(m_id)
+      , m_source_view(false) {}
 
-    explicit symbol(const struct position& position, const id_type& id)
-      : token(position)
-      , m_id(id) {}
+    explicit symbol(
+      const struct position& position,
+      id_type&& id,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
+      , m_id(std::move(id))
+      , m_view(m_id)
+      , m_source_view(false) {}
+
+    /**
+     * Constructs symbol which refers directly to the identifier in the source
+     * code instead of owning a copy of it. The source code must outlive the
+     * token.
+     *
+     * \param position Position in source code where the token was found from.
+     * \param view     Identifier of the symbol in the source code.
+     * \param end      Offset in source code where the token ends, or zero if
+     *                 it's not known.
+     */
+    explicit symbol(
+      const struct position& position,
+      source_view_t,
+      const std::u32string_view& view,
+      std::uint64_t end = 0
+    )
+      : token(position, end)
+      , m_view(view)
+      , m_source_view(true) {}
 
     inline enum type type() const
     {
@@ -241,16 +588,49 @@ namespace plorth::parser::ast
     }
 
     /**
-     * Returns identifier of the symbol.
+     * Returns identifier of the symbol. If the symbol refers to the source
+     * code, a copy of the identifier is made when this method is called for
+     * the first time.
      */
     inline const id_type& id() const
     {
+      if (m_source_view)
+      {
+        std::call_once(m_materialized, [this]()
+        {
+          m_id = id_type(std::u32string(m_view));
+        });
+      }
+
       return m_id;
     }
 
+    /**
+     * Returns identifier of the symbol without copying it.
+     */
+    inline const std::u32string_view& view() const
+    {
+      return m_view;
+    }
+
+    /**
+     * Returns true if the symbol refers directly to the source code instead
+     * of owning a copy of it's identifier.
+     */
+    inline bool is_source_view() const
+    {
+      return m_source_view;
+    }
+
   private:
+    /** Identifier of the symbol, once it has been copied. */
+    mutable id_type m_id;
     /** Identifier of the symbol. */
-    const id_type m_id;
+    const std::u32string_view m_view;
+    /** Whether the symbol refers directly to the source code. */
+    const bool m_source_view;
+    /** Used to copy the identifier from the source code only once. */
+    mutable std::once_flag m_materialized;
   };
 
   /**
@@ -263,9 +643,10 @@ namespace plorth::parser::ast
 
     explicit word(
       const struct position& position,
-      const symbol_type& symbol
+      const symbol_type& symbol,
+      std::uint64_t end = 0
     )
-      : token(position)
+      : token(position, end)
       , m_symbol(symbol) {}
 
     inline enum type type() const
@@ -285,4 +666,162 @@ namespace plorth::parser::ast
     /** Identifier of the word. */
     const symbol_type m_symbol;
   };
+
+  namespace internal
+  {
+    /**
+     * Destroys nested arrays, objects and quotes without recursion. Each
+     * token would otherwise destroy the tokens nested inside it from it's
+     * own destructor, so deeply nested trees would overflow the call stack
+     * when they are destroyed.
+     */
+    struct teardown
+    {
+      using container_type = std::vector<std::shared_ptr<token>>;
+
+      /**
+       * Returns true if there are tokens nested directly inside given token.
+       * Children of a lazy quote which have not been parsed yet do not
+       * count.
+       */
+      static bool has_children(const token& token)
+      {
+        switch (token.type())
+        {
+          case token::type::array:
+            return !static_cast<const array&>(token).m_elements.empty();
+
+          case token::type::object:
+            return !static_cast<const object&>(token).m_properties.empty();
+
+          case token::type::quote:
+            return !static_cast<const quote&>(token).m_children.empty();
+
+          default:
+            return false;
+        }
+      }
+
+      /**
+       * Moves the tokens nested directly inside given token into given
+       * container. Only called for tokens which are being destroyed, whose
+       * constness no longer applies.
+       */
+      static void take_children(token& token, container_type& pending)
+      {
+        switch (token.type())
+        {
+          case token::type::array:
+            take(
+              const_cast<array::container_type&>(
+                static_cast<array&>(token).m_elements
+              ),
+              pending
+            );
+            break;
+
+          case token::type::object:
+            for (auto& property : const_cast<object::container_type&>(
+              static_cast<object&>(token).m_properties
+            ))
+            {
+              pending.push_back(std::move(property.second));
+            }
+            break;
+
+          case token::type::quote:
+            take(static_cast<quote&>(token).m_children, pending);
+            break;
+
+          default:
+            break;
+        }
+      }
+
+      static void take(container_type& children, container_type& pending)
+      {
+        for (auto& child : children)
+        {
+          pending.push_back(std::move(child));
+        }
+      }
+
+      /**
+       * Returns true if destroying given child token would destroy tokens
+       * nested inside it as well.
+       */
+      static bool nested(const std::shared_ptr<token>& child)
+      {
+        return child && child.use_count() == 1 && has_children(*child);
+      }
+
+      /**
+       * Destroys the tokens in given container, and every token nested
+       * inside them which is not referred to from elsewhere, one at a time.
+       */
+      static void release(container_type& pending)
+      {
+        while (!pending.empty())
+        {
+          auto token = std::move(pending.back());
+
+          pending.pop_back();
+          if (nested(token))
+          {
+            take_children(*token, pending);
+          }
+        }
+      }
+    };
+  }
+
+  inline array::~array()
+  {
+    auto& elements = const_cast<container_type&>(m_elements);
+
+    if (std::any_of(
+      std::begin(elements),
+      std::end(elements),
+      internal::teardown::nested
+    ))
+    {
+      internal::teardown::release(elements);
+    }
+  }
+
+  inline object::~object()
+  {
+    auto& properties = const_cast<container_type&>(m_properties);
+
+    if (std::any_of(
+      std::begin(properties),
+      std::end(properties),
+      [](const value_type& property)
+      {
+        return internal::teardown::nested(property.second);
+      }
+    ))
+    {
+      internal::teardown::container_type pending;
+
+      pending.reserve(properties.size());
+      for (auto& property : properties)
+      {
+        pending.push_back(std::move(property.second));
+      }
+      internal::teardown::release(pending);
+    }
+  }
+
+  inline quote::~quote()
+  {
+    if (std::any_of(
+      std::begin(m_children),
+      std::end(m_children),
+      internal::teardown::nested
+    ))
+    {
+      internal::teardown::release(m_children);
+    }
+  }
 }
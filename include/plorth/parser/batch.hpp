@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/mapped_file.hpp>
+#include <plorth/parser/thread_pool.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * UTF-8 encoded source code parsed as part of a batch.
+   */
+  struct batch_source
+  {
+    /** Name of the file the source code was read from. */
+    interned_string file;
+    /** The source code. */
+    std::string_view source;
+  };
+
+  /**
+   * Parses multiple Plorth programs in parallel, using the given thread
+   * pool, and returns result of each parse in the same order as the
+   * programs were given.
+   *
+   * The builder is used from multiple threads at the same time, so it must
+   * be safe to do so. A symbol table shared by the parses must be
+   * constructed to be thread safe.
+   *
+   * \param sources Programs to parse. The source code must stay valid until
+   *                this function returns.
+   * \param pool    Thread pool used to parse the programs. This function
+   *                must not be called from a task running in the same pool.
+   * \param builder Builder used to construct the AST tokens.
+   */
+  template<class BuilderT = ast::builder<>>
+  std::vector<basic_parse_result<BuilderT>> parse_batch(
+    const std::vector<batch_source>& sources,
+    thread_pool& pool,
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    std::vector<std::future<basic_parse_result<BuilderT>>> futures;
+
+    futures.reserve(sources.size());
+    for (const auto& source : sources)
+    {
+      futures.push_back(pool.submit([&source, &builder]()
+      {
+        struct position position = { source.file, 1, 1 };
+
+        return parse(source.source, position, builder);
+      }));
+    }
+
+    return internal::wait_all(futures);
+  }
+
+  /**
+   * Reads and parses multiple UTF-8 encoded files in parallel, using the
+   * given thread pool, and returns result of each parse in the same order
+   * as the files were given. Files are memory mapped where possible. If a
+   * file cannot be opened, an error is returned for it.
+   *
+   * The builder is used from multiple threads at the same time, so it must
+   * be safe to do so. A symbol table shared by the parses must be
+   * constructed to be thread safe.
+   *
+   * \param paths   Paths of the files to parse.
+   * \param pool    Thread pool used to parse the files. This function must
+   *                not be called from a task running in the same pool.
+   * \param builder Builder used to construct the AST tokens.
+   */
+  template<class BuilderT = ast::builder<>>
+  std::vector<basic_parse_result<BuilderT>> parse_files(
+    const std::vector<std::string>& paths,
+    thread_pool& pool,
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    using result_type = basic_parse_result<BuilderT>;
+    std::vector<std::future<result_type>> futures;
+
+    futures.reserve(paths.size());
+    for (const auto& path : paths)
+    {
+      futures.push_back(pool.submit([&path, &builder]()
+      {
+        const mapped_file file(path);
+        struct position position = { utf8::decode(path), 1, 1 };
+
+        if (!file.is_open())
+        {
+          return result_type::error({ position, U"Unable to open file." });
+        }
+
+        return parse(file.view(), position, builder);
+      }));
+    }
+
+    return internal::wait_all(futures);
+  }
+}
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2026, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <memory>
+
+#include <plorth/parser/ast.hpp>
+#include <plorth/parser/symbol_table.hpp>
+
+namespace plorth::parser::ast
+{
+  /**
+   * Builder used by the parser to construct AST tokens. Each token is
+   * allocated with the allocator given to the builder, which allows the whole
+   * AST to be placed in an arena instead of the global heap.
+   *
+   * If the builder is given a symbol table, symbol identifiers and object
+   * keys are interned into it, so that equal identifiers share their storage
+   * and can be compared by identity. The symbol table must outlive the
+   * builder.
+   *
+   * If source views are enabled, string literals without escape sequences
+   * and symbols which are not interned refer directly to the source code
+   * instead of owning a copy of their contents. This is only possible when
+   * the source code is parsed from contiguous UTF-32 encoded memory, such as
+   * `std::u32string`, and the source code must then outlive the AST tokens.
+   *
+   * If deferred escapes are enabled, string literals containing escape
+   * sequences also refer to the source code, under the same conditions, and
+   * the escape sequences are decoded only when contents of the string
+   * literal are first accessed. They are still checked for errors while
+   * parsing.
+   *
+   * Parser functions accept any builder which provides the same member types
+   * and functions as this one, so the parser can also produce other
+   * representations of the program than the AST tokens. Functions which
+   * receive contents of string literals, symbols and object keys are given
+   * either a `std::u32string` rvalue, which the builder may take ownership
+   * of, or a `std::u32string_view` into the source code when the source code
+   * is parsed from contiguous memory.
+   */
+  template<class AllocatorT = std::allocator<token>>
+  class builder
+  {
+  public:
+    using allocator_type = AllocatorT;
+    using token_type = std::shared_ptr<token>;
+    using array_type = std::shared_ptr<array>;
+    using object_type = std::shared_ptr<object>;
+    using quote_type = std::shared_ptr<quote>;
+    using string_type = std::shared_ptr<string>;
+    using symbol_type = std::shared_ptr<symbol>;
+    using word_type = std::shared_ptr<word>;
+    using array_container_type = array::container_type;
+    using object_container_type = object::container_type;
+    using quote_container_type = quote::container_type;
+
+    explicit builder(const allocator_type& allocator = allocator_type())
+      : m_allocator(allocator)
+      , m_symbol_table(nullptr)
+      , m_source_views(false)
+      , m_deferred_escapes(false) {}
+
+    explicit builder(
+      class symbol_table& symbol_table,
+      const allocator_type& allocator = allocator_type()
+    )
+      : m_allocator(allocator)
+      , m_symbol_table(&symbol_table)
+      , m_source_views(false)
+      , m_deferred_escapes(false) {}
+
+    /**
+     * Returns the allocator used to allocate the AST tokens.
+     */
+    inline const allocator_type& get_allocator() const
+    {
+      return m_allocator;
+    }
+
+    /**
+     * Returns the symbol table used to intern identifiers, or null pointer if
+     * identifiers are not interned.
+     */
+    inline class symbol_table* symbol_table() const
+    {
+      return m_symbol_table;
+    }
+
+    /**
+     * Returns true if string literals and symbols constructed by the builder
+     * may refer directly to the source code.
+     */
+    inline bool source_views() const
+    {
+      return m_source_views;
+    }
+
+    /**
+     * Sets whether string literals and symbols constructed by the builder may
+     * refer directly to the source code instead of owning a copy of their
+     * contents. When enabled, the source code must outlive the AST tokens.
+     *
+     * Symbols refer to the source code only if the builder has no symbol
+     * table. When it has one, identifiers of symbols are always interned by
+     * the table, so that they can be compared by identity.
+     */
+    inline void set_source_views(bool source_views)
+    {
+      m_source_views = source_views;
+    }
+
+    /**
+     * Returns true if escape sequences in string literals constructed by the
+     * builder are decoded only when the string literals are first accessed.
+     */
+    inline bool deferred_escapes() const
+    {
+      return m_deferred_escapes;
+    }
+
+    /**
+     * Sets whether string literals containing escape sequences may refer
+     * directly to the source code, and decode the escape sequences only when
+     * they are first accessed. When enabled, the source code must outlive the
+     * AST tokens.
+     */
+    inline void set_deferred_escapes(bool deferred_escapes)
+    {
+      m_deferred_escapes = deferred_escapes;
+    }
+
+    array_type make_array(
+      const struct position& position,
+      std::uint64_t end,
+      array_container_type&& elements
+    ) const
+    {
+      return std::allocate_shared<array>(
+        m_allocator,
+        position,
+        std::move(elements),
+        end
+      );
+    }
+
+    object::key_type make_key(
+      const struct position&,
+      std::uint64_t,
+      std::u32string&& key
+    ) const
+    {
+      return intern(std::move(key));
+    }
+
+    object::key_type make_key(
+      const struct position&,
+      std::uint64_t,
+      const std::u32string_view& key
+    ) const
+    {
+      return intern(key);
+    }
+
+    object_type make_object(
+      const struct position& position,
+      std::uint64_t end,
+      object_container_type&& properties
+    ) const
+    {
+      return std::allocate_shared<object>(
+        m_allocator,
+        position,
+        std::move(properties),
+        end
+      );
+    }
+
+    quote_type make_quote(
+      const struct position& position,
+      std::uint64_t end,
+      quote_container_type&& children
+    ) const
+    {
+      return std::allocate_shared<quote>(
+        m_allocator,
+        position,
+        std::move(children),
+        end
+      );
+    }
+
+    string_type make_string(
+      const struct position& position,
+      std::uint64_t end,
+      string::value_type&& value
+    ) const
+    {
+      return std::allocate_shared<string>(
+        m_allocator,
+        position,
+        std::move(value),
+        end
+      );
+    }
+
+    string_type make_string(
+      const struct position& position,
+      std::uint64_t end,
+      const std::u32string_view& value
+    ) const
+    {
+      if (m_source_views)
+      {
+        return std::allocate_shared<source_string>(
+          m_allocator,
+          position,
+          source_view,
+          value,
+          end
+        );
+      }
+
+      return std::allocate_shared<string>(
+        m_allocator,
+        position,
+        string::value_type(value),
+        end
+      );
+    }
+
+    string_type make_escaped_string(
+      const struct position& position,
+      std::uint64_t end,
+      const std::u32string_view& source
+    ) const
+    {
+      return std::allocate_shared<source_string>(
+        m_allocator,
+        position,
+        escaped_source_view,
+        source,
+        end
+      );
+    }
+
+    symbol_type make_symbol(
+      const struct position& position,
+      std::uint64_t end,
+      std::u32string&& id
+    ) const
+    {
+      return std::allocate_shared<symbol>(
+        m_allocator,
+        position,
+        intern(std::move(id)),
+        end
+      );
+    }
+
+    symbol_type make_symbol(
+      const struct position& position,
+      std::uint64_t end,
+      const std::u32string_view& id
+    ) const
+    {
+      // Identifiers are always interned when there is a symbol table, so
+      // that no symbol bypasses it. Interning an identifier which is already
+      // in the table does not allocate anything either.
+      if (m_source_views && !m_symbol_table)
+      {
+        return std::allocate_shared<symbol>(
+          m_allocator,
+          position,
+          source_view,
+          id,
+          end
+        );
+      }
+
+      return std::allocate_shared<symbol>(
+        m_allocator,
+        position,
+        intern(id),
+        end
+      );
+    }
+
+    word_type make_word(
+      const struct position& position,
+      std::uint64_t end,
+      symbol_type&& symbol
+    ) const
+    {
+      return std::allocate_shared<word>(
+        m_allocator,
+        position,
+        std::move(symbol),
+        end
+      );
+    }
+
+  private:
+    interned_string intern(std::u32string&& value) const
+    {
+      if (m_symbol_table)
+      {
+        return m_symbol_table->intern(std::move(value));
+      }
+
+      return interned_string(std::move(value));
+    }
+
+    interned_string intern(const std::u32string_view& value) const
+    {
+      if (m_symbol_table)
+      {
+        return m_symbol_table->intern(value);
+      }
+
+      return interned_string(std::u32string(value));
+    }
+
+    allocator_type m_allocator;
+    class symbol_table* m_symbol_table;
+    bool m_source_views;
+    bool m_deferred_escapes;
+  };
+}
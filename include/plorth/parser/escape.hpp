@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+
+#include <peelo/result.hpp>
+#include <peelo/unicode/ctype/isvalid.hpp>
+#include <peelo/unicode/ctype/isxdigit.hpp>
+#include <plorth/parser/error.hpp>
+#include <plorth/parser/utils.hpp>
+
+namespace plorth::parser
+{
+  using parse_escape_sequence_result = peelo::result<
+    char32_t,
+    error
+  >;
+
+  /**
+   * Attempts to parse string literal escape sequence.
+   *
+   * \param current  Iterator pointing to current position in source code.
+   * \param end      Iterator pointing to end of the source code.
+   * \param position Current source code position.
+   */
+  template<class IteratorT>
+  parse_escape_sequence_result parse_escape_sequence(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position
+  )
+  {
+    char32_t c;
+    char32_t result;
+
+    if (current >= end)
+    {
+      return parse_escape_sequence_result::error({
+        position,
+        U"Unexpected end of input; Missing escape sequence."
+      });
+    }
+
+    if (!utils::peek_advance(current, end, position, U'\\'))
+    {
+      return parse_escape_sequence_result::error({
+        position,
+        U"Unexpected input; Missing escape sequence."
+      });
+    }
+
+    if (current >= end)
+    {
+      return parse_escape_sequence_result::error({
+        position,
+        U"Unexpected end of input; Missing escape sequence."
+      });
+    }
+
+    switch (c = utils::advance(current, position))
+    {
+      case 'b':
+        result = 010;
+        break;
+
+      case 't':
+        result = 011;
+        break;
+
+      case 'n':
+        result = 012;
+        break;
+
+      case 'f':
+        result = 014;
+        break;
+
+      case 'r':
+        result = 015;
+        break;
+
+      case '"':
+      case '\'':
+      case '\\':
+      case '/':
+        result = c;
+        break;
+
+      case 'u':
+        result = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+          if (current >= end)
+          {
+            return parse_escape_sequence_result::error({
+              position,
+              U"Unterminated escape sequence."
+            });
+          }
+          else if (!peelo::unicode::ctype::isxdigit(*current))
+          {
+            return parse_escape_sequence_result::error({
+              position,
+              U"Illegal Unicode hex escape sequence."
+            });
+          }
+
+          if (*current >= 'A' && *current <= 'F')
+          {
+            result = result * 16 + (*current - 'A' + 10);
+          }
+          else if (*current >= 'a' && *current <= 'f')
+          {
+            result = result * 16 + (*current - 'a' + 10);
+          } else {
+            result = result * 16 + (*current - '0');
+          }
+
+          utils::advance(current, position);
+        }
+
+        if (!peelo::unicode::ctype::isvalid(result))
+        {
+          return parse_escape_sequence_result::error({
+            position,
+            U"Illegal Unicode hex escape sequence."
+          });
+        }
+        break;
+
+      default:
+        return parse_escape_sequence_result::error({
+          position,
+          U"Illegal escape sequence in string literal."
+        });
+    }
+
+    return parse_escape_sequence_result::ok(result);
+  }
+
+  /**
+   * Decodes escape sequences in contents of a string literal, which have
+   * already been checked to be valid by the parser.
+   *
+   * \param source Contents of the string literal in the source code,
+   *               without the surrounding quotes.
+   */
+  inline std::u32string decode_escape_sequences(
+    const std::u32string_view& source
+  )
+  {
+    std::u32string result;
+    struct position position;
+    auto current = source.data();
+    const auto end = current + source.length();
+
+    result.reserve(source.length());
+    while (current < end)
+    {
+      const auto backslash = std::find(current, end, U'\\');
+
+      result.append(current, backslash);
+      current = backslash;
+      if (current < end)
+      {
+        const auto escape_sequence_result = parse_escape_sequence(
+          current,
+          end,
+          position
+        );
+
+        if (!escape_sequence_result)
+        {
+          break;
+        }
+        result.append(1, *escape_sequence_result);
+      }
+    }
+
+    return result;
+  }
+}
@@ -0,0 +1,528 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <limits>
+
+#include <plorth/parser.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Base class for handlers of parse_events(), which ignores every event.
+   * Handlers can inherit from this and hide only the methods of events they
+   * are interested in. The handler is given to parse_events() as a template
+   * parameter, so the methods are not virtual and calls to them can be
+   * inlined.
+   *
+   * Contents of string literals, symbols and object keys are given as views
+   * which remain valid only until the method returns.
+   */
+  struct event_handler
+  {
+    inline void on_array_begin(const struct position&) {}
+
+    inline void on_array_end(const struct position&, std::uint64_t) {}
+
+    inline void on_object_begin(const struct position&) {}
+
+    inline void on_object_key(
+      const struct position&,
+      std::uint64_t,
+      const std::u32string_view&
+    ) {}
+
+    inline void on_object_end(const struct position&, std::uint64_t) {}
+
+    inline void on_quote_begin(const struct position&) {}
+
+    inline void on_quote_end(const struct position&, std::uint64_t) {}
+
+    inline void on_string(
+      const struct position&,
+      std::uint64_t,
+      const std::u32string_view&
+    ) {}
+
+    inline void on_symbol(
+      const struct position&,
+      std::uint64_t,
+      const std::u32string_view&
+    ) {}
+
+    /**
+     * Receives word definition. Position of the symbol which follows `->' is
+     * given in addition to position of the word definition.
+     */
+    inline void on_word(
+      const struct position&,
+      std::uint64_t,
+      const struct position&,
+      const std::u32string_view&
+    ) {}
+  };
+
+  namespace internal
+  {
+    /**
+     * Array, object or quote which is currently being parsed by
+     * parse_events().
+     */
+    struct event_frame
+    {
+      /** Opening bracket of the container. */
+      char32_t bracket;
+      /** Position of the container in source code. */
+      struct position position;
+    };
+
+    inline char32_t closing_bracket(char32_t bracket)
+    {
+      return bracket == U'[' ? U']' : bracket == U'{' ? U'}' : U')';
+    }
+
+    inline error unterminated(const event_frame& frame)
+    {
+      if (frame.bracket == U'[')
+      {
+        return { frame.position, U"Unterminated array; Missing `]'." };
+      }
+      else if (frame.bracket == U'{')
+      {
+        return { frame.position, U"Unterminated object; Missing `}'." };
+      }
+
+      return { frame.position, U"Unterminated quote; Missing `)'." };
+    }
+
+    /**
+     * Parses identifier of a symbol into given structure. The identifier is
+     * given as a slice of the source code if it's stored in contiguous
+     * memory, or copied into the buffer otherwise. If decoding is disabled,
+     * the structure is left empty.
+     */
+    template<bool Decode, class IteratorT>
+    void parse_identifier(
+      IteratorT& current,
+      const IteratorT& end,
+      struct position& position,
+      string_literal& literal
+    )
+    {
+      const auto begin = current;
+
+      literal.slice.reset();
+      literal.buffer.clear();
+
+      do
+      {
+        utils::advance(current, position);
+        utils::advance_run(
+          current,
+          end,
+          position,
+          scan::skip_word,
+          scan::ascii::skip_word
+        );
+      }
+      while (current < end && utils::isword(*current));
+
+      if constexpr (Decode && utils::is_contiguous_v<IteratorT>)
+      {
+        literal.slice = utils::slice(begin, current);
+      }
+      else if constexpr (Decode)
+      {
+        literal.buffer.assign(begin, current);
+      }
+    }
+
+    inline std::u32string_view view(const string_literal& literal)
+    {
+      if (literal.slice)
+      {
+        return *literal.slice;
+      }
+
+      return literal.buffer;
+    }
+
+    /**
+     * Forwards events of the parsing loop to an event handler, giving
+     * contents of string literals, symbols and object keys to it as views.
+     */
+    template<class HandlerT>
+    class event_adapter
+    {
+    public:
+      explicit event_adapter(HandlerT& handler)
+        : m_handler(handler) {}
+
+      inline void on_array_begin(const struct position& position)
+      {
+        m_handler.on_array_begin(position);
+      }
+
+      inline void on_array_end(
+        const struct position& position,
+        std::uint64_t end
+      )
+      {
+        m_handler.on_array_end(position, end);
+      }
+
+      inline void on_object_begin(const struct position& position)
+      {
+        m_handler.on_object_begin(position);
+      }
+
+      inline void on_object_key(
+        const struct position& position,
+        std::uint64_t end,
+        string_literal& key
+      )
+      {
+        m_handler.on_object_key(position, end, view(key));
+      }
+
+      inline void on_object_end(
+        const struct position& position,
+        std::uint64_t end
+      )
+      {
+        m_handler.on_object_end(position, end);
+      }
+
+      inline void on_quote_begin(const struct position& position)
+      {
+        m_handler.on_quote_begin(position);
+      }
+
+      inline void on_quote_end(
+        const struct position& position,
+        std::uint64_t end
+      )
+      {
+        m_handler.on_quote_end(position, end);
+      }
+
+      inline void on_string(
+        const struct position& position,
+        std::uint64_t end,
+        string_literal& value
+      )
+      {
+        m_handler.on_string(position, end, view(value));
+      }
+
+      inline void on_symbol(
+        const struct position& position,
+        std::uint64_t end,
+        string_literal& id
+      )
+      {
+        m_handler.on_symbol(position, end, view(id));
+      }
+
+      inline void on_word(
+        const struct position& position,
+        std::uint64_t end,
+        const struct position& symbol_position,
+        string_literal& id
+      )
+      {
+        m_handler.on_word(position, end, symbol_position, view(id));
+      }
+
+    private:
+      HandlerT& m_handler;
+    };
+  }
+
+  namespace internal
+  {
+    /**
+     * Parsing loop shared by parse_events(), validate() and
+     * parse_iterative(). Contents of string literals, symbols and object
+     * keys are given to the handler in a structure which is reused between
+     * them, and which the handler may move the buffer out of. If decoding is
+     * disabled, the structure is left empty, except that string literals
+     * are given undecoded as slices of contiguous source code.
+     *
+     * Arrays, objects and quotes nested deeper than given maximum depth are
+     * reported as errors. If only a single value is requested, parsing stops
+     * after the first top level value.
+     */
+    template<bool Decode, class IteratorT, class HandlerT>
+    std::optional<error> parse_events(
+      IteratorT& current,
+      const IteratorT& end,
+      struct position& position,
+      HandlerT& handler,
+      std::size_t max_depth = std::numeric_limits<std::size_t>::max(),
+      bool single_value = false
+    )
+    {
+      std::vector<event_frame> stack;
+      string_literal literal;
+
+      while (!stack.empty() || current < end)
+      {
+        bool closed = false;
+
+        if (!stack.empty())
+        {
+          const auto bracket = stack.back().bracket;
+
+          if (utils::skip_whitespace(current, end, position))
+          {
+            return unterminated(stack.back());
+          }
+          else if (utils::peek_advance(
+            current,
+            end,
+            position,
+            closing_bracket(bracket)
+          ))
+          {
+            const auto& frame = stack.back();
+
+            if (bracket == U'[')
+            {
+              handler.on_array_end(frame.position, position.offset);
+            }
+            else if (bracket == U'{')
+            {
+              handler.on_object_end(frame.position, position.offset);
+            } else {
+              handler.on_quote_end(frame.position, position.offset);
+            }
+            stack.pop_back();
+            closed = true;
+          }
+          else if (bracket == U'{')
+          {
+            struct position key_position;
+
+            if (auto key_error = parse_string_literal<IteratorT, Decode>(
+              current,
+              end,
+              position,
+              key_position,
+              literal
+            ))
+            {
+              return key_error;
+            }
+            handler.on_object_key(key_position, position.offset, literal);
+            if (utils::skip_whitespace(current, end, position))
+            {
+              return error({
+                stack.back().position,
+                U"Unterminated object; Missing `:'."
+              });
+            }
+            else if (!utils::peek_advance(current, end, position, U':'))
+            {
+              return error({
+                stack.back().position,
+                U"Missing `:' after property key."
+              });
+            }
+          }
+        }
+
+        if (!closed)
+        {
+          if (utils::skip_whitespace(current, end, position))
+          {
+            return error({
+              position,
+              U"Unexpected end of input; Missing value."
+            });
+          }
+
+          const auto c = *current;
+
+          if (c == U'[' || c == U'{' || c == U'(')
+          {
+            if (stack.size() >= max_depth)
+            {
+              return error({ position, U"Maximum nesting depth exceeded." });
+            }
+            stack.push_back({ c, position });
+            utils::advance(current, position);
+            if (c == U'[')
+            {
+              handler.on_array_begin(stack.back().position);
+            }
+            else if (c == U'{')
+            {
+              handler.on_object_begin(stack.back().position);
+            } else {
+              handler.on_quote_begin(stack.back().position);
+            }
+            continue;
+          }
+          else if (c == U'"' || c == U'\'')
+          {
+            struct position string_position;
+
+            if (auto string_error = parse_string_literal<IteratorT, Decode>(
+              current,
+              end,
+              position,
+              string_position,
+              literal
+            ))
+            {
+              return string_error;
+            }
+            handler.on_string(string_position, position.offset, literal);
+          }
+          else if (!utils::isword(c))
+          {
+            return error({
+              position,
+              U"Unexpected input; Missing symbol or word definition."
+            });
+          } else {
+            const auto symbol_or_word_position = position;
+            const auto begin = current;
+
+            parse_identifier<Decode>(current, end, position, literal);
+
+            if (utils::equals(begin, current, U"->"))
+            {
+              if (utils::skip_whitespace(current, end, position))
+              {
+                return error({
+                  position,
+                  U"Unexpected end of input; Missing symbol."
+                });
+              }
+              else if (!utils::isword(*current))
+              {
+                return error({
+                  position,
+                  U"Unexpected input; Missing symbol."
+                });
+              }
+
+              const auto symbol_position = position;
+
+              parse_identifier<Decode>(current, end, position, literal);
+              handler.on_word(
+                symbol_or_word_position,
+                position.offset,
+                symbol_position,
+                literal
+              );
+            } else {
+              handler.on_symbol(
+                symbol_or_word_position,
+                position.offset,
+                literal
+              );
+            }
+          }
+        }
+
+        if (!stack.empty() && stack.back().bracket != U'(')
+        {
+          const auto closing = closing_bracket(stack.back().bracket);
+
+          if (utils::skip_whitespace(current, end, position)
+              || (!utils::peek(current, end, U',')
+                && !utils::peek(current, end, closing)))
+          {
+            return unterminated(stack.back());
+          }
+          utils::peek_advance(current, end, position, U',');
+        }
+        else if (single_value && stack.empty())
+        {
+          break;
+        }
+      }
+
+      return std::nullopt;
+    }
+  }
+
+  /**
+   * Parses an entire Plorth program and reports the values encountered in
+   * the source code to given handler as events, without constructing any
+   * AST tokens. Arrays, objects and quotes are reported as begin and end
+   * events, between which their contents are reported.
+   *
+   * Nested values are tracked with an explicit stack instead of recursion,
+   * and memory used for decoding string literals and symbols is reused
+   * between them. Errors are identical to the ones reported by parse().
+   * Events already received by the handler are not retracted when an error
+   * is encountered.
+   *
+   * \param current  Iterator pointing to current position in source code.
+   * \param end      Iterator pointing to end of the source code.
+   * \param position Current source code position.
+   * \param handler  Handler which receives the events.
+   * \return         Error if the source code could not be parsed.
+   */
+  template<class IteratorT, class HandlerT>
+  std::optional<error> parse_events(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position,
+    HandlerT& handler
+  )
+  {
+    internal::event_adapter<HandlerT> adapter(handler);
+
+    return internal::parse_events<true>(current, end, position, adapter);
+  }
+
+  /**
+   * Parses an entire Plorth program from UTF-8 encoded source code and
+   * reports the values encountered in it to given handler as events.
+   *
+   * \param source   UTF-8 encoded source code.
+   * \param position Current source code position.
+   * \param handler  Handler which receives the events.
+   * \return         Error if the source code could not be parsed.
+   */
+  template<class HandlerT>
+  std::optional<error> parse_events(
+    const std::string_view& source,
+    struct position& position,
+    HandlerT& handler
+  )
+  {
+    auto current = utf8::begin(source);
+    const auto end = utf8::end(source);
+
+    return parse_events(current, end, position, handler);
+  }
+}
@@ -0,0 +1,718 @@
+/*
+ * Copyright (c) 2026, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/line_index.hpp>
+
+namespace plorth::parser::flat
+{
+  /**
+   * Type used to refer to nodes of flat tree.
+   */
+  using index_type = std::uint32_t;
+
+  /**
+   * Contiguous range of node indices stored in flat tree.
+   */
+  class index_range
+  {
+  public:
+    using const_iterator = const index_type*;
+
+    explicit index_range(const index_type* begin, const index_type* end)
+      : m_begin(begin)
+      , m_end(end) {}
+
+    inline const_iterator begin() const
+    {
+      return m_begin;
+    }
+
+    inline const_iterator end() const
+    {
+      return m_end;
+    }
+
+    inline std::size_t size() const
+    {
+      return m_end - m_begin;
+    }
+
+    inline bool empty() const
+    {
+      return m_begin == m_end;
+    }
+
+    inline index_type operator[](std::size_t n) const
+    {
+      return m_begin[n];
+    }
+
+  private:
+    const index_type* m_begin;
+    const index_type* m_end;
+  };
+
+  /**
+   * Alternative representation of parsed Plorth program, where all nodes of
+   * the program are stored in a handful of contiguous tables and nodes refer
+   * to each other with 32-bit indices instead of pointers. Nodes are stored
+   * in post-order, so children of a node always precede the node itself.
+   *
+   * Children of each node depend on type of the node:
+   *
+   * - Arrays and quotes have their elements as children.
+   * - Objects have their properties as children, key followed by value, where
+   *   keys are string nodes.
+   * - Words have the symbol they define as their only child.
+   * - Strings and symbols have no children, but they have text instead.
+   *
+   * Each node takes 17 bytes: its type, 32-bit source offsets of its
+   * beginning and end, and a 32-bit range of its children or text. Line and
+   * column numbers are not stored at all; they are resolved from the
+   * offsets with a line index of the source code when needed. Programs which
+   * do not fit into 32-bit indices and offsets make the tree overflow, see
+   * overflowed().
+   */
+  class tree
+  {
+  public:
+    tree() = default;
+
+    /**
+     * Constructs empty tree for source code read from given file.
+     */
+    explicit tree(const interned_string& file)
+      : m_file(file) {}
+
+    /**
+     * Returns number of nodes in the tree.
+     */
+    inline std::size_t size() const
+    {
+      return m_types.size();
+    }
+
+    /**
+     * Returns true if the program given to the builder was too large to be
+     * addressed with 32-bit indices and offsets. Contents of such tree are
+     * not usable.
+     */
+    inline bool overflowed() const
+    {
+      return m_overflowed;
+    }
+
+    /**
+     * Returns the top level nodes of the tree.
+     */
+    inline index_range roots() const
+    {
+      return index_range(
+        m_roots.data(),
+        m_roots.data() + m_roots.size()
+      );
+    }
+
+    /**
+     * Returns type of given node.
+     */
+    inline enum ast::token::type type(index_type node) const
+    {
+      return static_cast<enum ast::token::type>(m_types[node]);
+    }
+
+    /**
+     * Returns position in source code where given node was found from.
+     *
+     * \param node  Node to return position of.
+     * \param lines Line index of the source code the tree was parsed from.
+     */
+    template<class CharT>
+    inline struct position position(
+      index_type node,
+      const basic_line_index<CharT>& lines
+    ) const
+    {
+      return lines.locate(m_spans[node].begin, m_file);
+    }
+
+    /**
+     * Returns the range of source code given node was parsed from.
+     */
+    inline source_span span(index_type node) const
+    {
+      const auto& offsets = m_spans[node];
+
+      return { offsets.begin, offsets.end };
+    }
+
+    /**
+     * Returns children of given node.
+     */
+    inline index_range children(index_type node) const
+    {
+      if (has_text(node))
+      {
+        return index_range(nullptr, nullptr);
+      }
+
+      const auto& range = m_ranges[node];
+      const auto begin = m_children.data() + range.first;
+
+      return index_range(begin, begin + range.count);
+    }
+
+    /**
+     * Returns text of given string or symbol node.
+     */
+    inline std::u32string_view text(index_type node) const
+    {
+      const auto& range = m_ranges[node];
+
+      return std::u32string_view(m_text).substr(range.first, range.count);
+    }
+
+  private:
+    inline bool has_text(index_type node) const
+    {
+      const auto type = this->type(node);
+
+      return type == ast::token::type::string
+        || type == ast::token::type::symbol;
+    }
+
+    struct offsets
+    {
+      std::uint32_t begin;
+      std::uint32_t end;
+    };
+
+    struct range
+    {
+      index_type first;
+      index_type count;
+    };
+
+    static inline bool fits(std::uint64_t value)
+    {
+      return value <= std::numeric_limits<std::uint32_t>::max();
+    }
+
+    index_type add_node(
+      enum ast::token::type type,
+      const struct position& position,
+      std::uint64_t end,
+      const range& range
+    )
+    {
+      const auto index = static_cast<index_type>(m_types.size());
+
+      if (!fits(m_types.size()) || !fits(position.offset) || !fits(end))
+      {
+        m_overflowed = true;
+      }
+      m_types.push_back(static_cast<std::uint8_t>(type));
+      m_spans.push_back({
+        static_cast<std::uint32_t>(position.offset),
+        static_cast<std::uint32_t>(end)
+      });
+      m_ranges.push_back(range);
+
+      return index;
+    }
+
+    template<class InputIteratorT>
+    range add_children(InputIteratorT first, InputIteratorT last)
+    {
+      const auto begin = m_children.size();
+
+      m_children.insert(std::end(m_children), first, last);
+      if (!fits(m_children.size()))
+      {
+        m_overflowed = true;
+      }
+
+      return {
+        static_cast<index_type>(begin),
+        static_cast<index_type>(m_children.size() - begin)
+      };
+    }
+
+    template<class ContainerT>
+    range add_properties(const ContainerT& properties)
+    {
+      const auto begin = m_children.size();
+
+      for (const auto& property : properties)
+      {
+        m_children.push_back(property.first);
+        m_children.push_back(property.second);
+      }
+      if (!fits(m_children.size()))
+      {
+        m_overflowed = true;
+      }
+
+      return {
+        static_cast<index_type>(begin),
+        static_cast<index_type>(m_children.size() - begin)
+      };
+    }
+
+    range add_text(const std::u32string_view& text)
+    {
+      const auto begin = m_text.length();
+
+      m_text.append(text);
+      if (!fits(m_text.length()))
+      {
+        m_overflowed = true;
+      }
+
+      return {
+        static_cast<index_type>(begin),
+        static_cast<index_type>(text.length())
+      };
+    }
+
+    friend class builder;
+
+    interned_string m_file;
+    std::vector<std::uint8_t> m_types;
+    std::vector<offsets> m_spans;
+    std::vector<range> m_ranges;
+    std::vector<index_type> m_children;
+    std::u32string m_text;
+    std::vector<index_type> m_roots;
+    bool m_overflowed = false;
+  };
+
+  /**
+   * Builder which makes the parser emit nodes directly into a flat tree,
+   * without constructing the AST tokens at all.
+   */
+  class builder
+  {
+  public:
+    using token_type = index_type;
+    using array_type = index_type;
+    using object_type = index_type;
+    using quote_type = index_type;
+    using string_type = index_type;
+    using symbol_type = index_type;
+    using word_type = index_type;
+    using array_container_type = std::vector<index_type>;
+    using object_container_type = std::vector<
+      std::pair<index_type, index_type>
+    >;
+    using quote_container_type = std::vector<index_type>;
+
+    explicit builder(class tree& tree)
+      : m_tree(&tree) {}
+
+    array_type make_array(
+      const struct position& position,
+      std::uint64_t end,
+      array_container_type&& elements
+    ) const
+    {
+      return m_tree->add_node(
+        ast::token::type::array,
+        position,
+        end,
+        m_tree->add_children(std::begin(elements), std::end(elements))
+      );
+    }
+
+    index_type make_key(
+      const struct position& position,
+      std::uint64_t end,
+      const std::u32string_view& key
+    ) const
+    {
+      return make_string(position, end, key);
+    }
+
+    object_type make_object(
+      const struct position& position,
+      std::uint64_t end,
+      object_container_type&& properties
+    ) const
+    {
+      return m_tree->add_node(
+        ast::token::type::object,
+        position,
+        end,
+        m_tree->add_properties(properties)
+      );
+    }
+
+    quote_type make_quote(
+      const struct position& position,
+      std::uint64_t end,
+      quote_container_type&& children
+    ) const
+    {
+      return m_tree->add_node(
+        ast::token::type::quote,
+        position,
+        end,
+        m_tree->add_children(std::begin(children), std::end(children))
+      );
+    }
+
+    string_type make_string(
+      const struct position& position,
+      std::uint64_t end,
+      const std::u32string_view& value
+    ) const
+    {
+      return m_tree->add_node(
+        ast::token::type::string,
+        position,
+        end,
+        m_tree->add_text(value)
+      );
+    }
+
+    symbol_type make_symbol(
+      const struct position& position,
+      std::uint64_t end,
+      const std::u32string_view& id
+    ) const
+    {
+      return m_tree->add_node(
+        ast::token::type::symbol,
+        position,
+        end,
+        m_tree->add_text(id)
+      );
+    }
+
+    word_type make_word(
+      const struct position& position,
+      std::uint64_t end,
+      symbol_type&& symbol
+    ) const
+    {
+      return m_tree->add_node(
+        ast::token::type::word,
+        position,
+        end,
+        m_tree->add_children(&symbol, &symbol + 1)
+      );
+    }
+
+    /**
+     * Sets the top level nodes of the tree.
+     */
+    void set_roots(std::vector<index_type>&& roots) const
+    {
+      m_tree->m_roots = std::move(roots);
+    }
+
+  private:
+    class tree* m_tree;
+  };
+
+  using parse_result = peelo::result<tree, error>;
+
+  /**
+   * Attempts to parse an entire Plorth program into a flat tree.
+   *
+   * \param current  Iterator pointing to current position in source code.
+   * \param end      Iterator pointing to end of the source code.
+   * \param position Current source code position.
+   */
+  template<class IteratorT>
+  parse_result parse(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position
+  )
+  {
+    class tree tree(position.file);
+    const class builder builder(tree);
+    auto result = parser::parse(current, end, position, builder);
+
+    if (!result)
+    {
+      return parse_result::error(result.error());
+    }
+    builder.set_roots(std::move(*result));
+
+    if (tree.overflowed())
+    {
+      return parse_result::error({
+        position,
+        U"Program is too large to be stored in a flat tree."
+      });
+    }
+
+    return parse_result::ok(std::move(tree));
+  }
+
+  namespace internal
+  {
+    template<class CharT, class BuilderT>
+    typename BuilderT::token_type to_ast(
+      const tree& tree,
+      index_type node,
+      const basic_line_index<CharT>& lines,
+      const BuilderT& builder
+    )
+    {
+      const auto children = tree.children(node);
+      const auto position = tree.position(node, lines);
+      const auto end = tree.span(node).end;
+
+      switch (tree.type(node))
+      {
+        case ast::token::type::array:
+          {
+            typename BuilderT::array_container_type elements;
+
+            elements.reserve(children.size());
+            for (const auto child : children)
+            {
+              elements.push_back(to_ast(tree, child, lines, builder));
+            }
+
+            return builder.make_array(position, end, std::move(elements));
+          }
+
+        case ast::token::type::object:
+          {
+            typename BuilderT::object_container_type properties;
+
+            properties.reserve(children.size() / 2);
+            for (std::size_t i = 0; i + 1 < children.size(); i += 2)
+            {
+              properties.emplace_back(
+                builder.make_key(
+                  tree.position(children[i], lines),
+                  tree.span(children[i]).end,
+                  std::u32string(tree.text(children[i]))
+                ),
+                to_ast(tree, children[i + 1], lines, builder)
+              );
+            }
+
+            return builder.make_object(position, end, std::move(properties));
+          }
+
+        case ast::token::type::quote:
+          {
+            typename BuilderT::quote_container_type elements;
+
+            elements.reserve(children.size());
+            for (const auto child : children)
+            {
+              elements.push_back(to_ast(tree, child, lines, builder));
+            }
+
+            return builder.make_quote(position, end, std::move(elements));
+          }
+
+        case ast::token::type::string:
+          return builder.make_string(
+            position,
+            end,
+            std::u32string(tree.text(node))
+          );
+
+        case ast::token::type::symbol:
+          return builder.make_symbol(
+            position,
+            end,
+            std::u32string(tree.text(node))
+          );
+
+        case ast::token::type::word:
+          return builder.make_word(
+            position,
+            end,
+            builder.make_symbol(
+              tree.position(children[0], lines),
+              tree.span(children[0]).end,
+              std::u32string(tree.text(children[0]))
+            )
+          );
+      }
+
+      return typename BuilderT::token_type();
+    }
+
+    inline index_type from_ast(const ast::token& token, const builder& builder)
+    {
+      const auto& position = token.position();
+      const auto end = token.span().end;
+
+      switch (token.type())
+      {
+        case ast::token::type::array:
+          {
+            const auto& array = static_cast<const ast::array&>(token);
+            builder::array_container_type elements;
+
+            elements.reserve(array.elements().size());
+            for (const auto& element : array.elements())
+            {
+              elements.push_back(from_ast(*element, builder));
+            }
+
+            return builder.make_array(position, end, std::move(elements));
+          }
+
+        case ast::token::type::object:
+          {
+            const auto& object = static_cast<const ast::object&>(token);
+            builder::object_container_type properties;
+
+            properties.reserve(object.properties().size());
+            for (const auto& property : object.properties())
+            {
+              // Keys of AST objects do not have positions of their own.
+              auto key = builder.make_key(
+                position,
+                position.offset,
+                std::u32string(property.first.str())
+              );
+
+              properties.emplace_back(
+                key,
+                from_ast(*property.second, builder)
+              );
+            }
+
+            return builder.make_object(position, end, std::move(properties));
+          }
+
+        case ast::token::type::quote:
+          {
+            const auto& quote = static_cast<const ast::quote&>(token);
+            builder::quote_container_type children;
+
+            children.reserve(quote.children().size());
+            for (const auto& child : quote.children())
+            {
+              children.push_back(from_ast(*child, builder));
+            }
+
+            return builder.make_quote(position, end, std::move(children));
+          }
+
+        case ast::token::type::string:
+          return builder.make_string(
+            position,
+            end,
+            std::u32string(static_cast<const ast::string&>(token).value())
+          );
+
+        case ast::token::type::symbol:
+          return builder.make_symbol(
+            position,
+            end,
+            std::u32string(static_cast<const ast::symbol&>(token).id().str())
+          );
+
+        case ast::token::type::word:
+          {
+            const auto& symbol = static_cast<const ast::word&>(
+              token
+            ).symbol();
+
+            return builder.make_word(
+              position,
+              end,
+              builder.make_symbol(
+                symbol->position(),
+                symbol->span().end,
+                std::u32string(symbol->id().str())
+              )
+            );
+          }
+      }
+
+      return 0;
+    }
+  }
+
+  /**
+   * Converts given flat tree into AST tokens, using given builder to
+   * construct the tokens.
+   *
+   * \param tree    Tree to convert.
+   * \param lines   Line index of the source code the tree was parsed from,
+   *                used to resolve positions of the tokens.
+   * \param builder Builder used to construct the tokens.
+   */
+  template<class CharT, class BuilderT = ast::builder<>>
+  std::vector<typename BuilderT::token_type> to_ast(
+    const tree& tree,
+    const basic_line_index<CharT>& lines,
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    std::vector<typename BuilderT::token_type> result;
+
+    result.reserve(tree.roots().size());
+    for (const auto root : tree.roots())
+    {
+      result.push_back(internal::to_ast(tree, root, lines, builder));
+    }
+
+    return result;
+  }
+
+  /**
+   * Converts given AST tokens into a flat tree. File name of the tree is
+   * taken from position of the first token.
+   */
+  inline tree from_ast(const std::vector<std::shared_ptr<ast::token>>& tokens)
+  {
+    class tree tree(
+      tokens.empty() ? interned_string() : tokens[0]->position().file
+    );
+    const class builder builder(tree);
+    std::vector<index_type> roots;
+
+    roots.reserve(tokens.size());
+    for (const auto& token : tokens)
+    {
+      roots.push_back(internal::from_ast(*token, builder));
+    }
+    builder.set_roots(std::move(roots));
+
+    return tree;
+  }
+}
@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <type_traits>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/traversal.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Describes a change made to source code: a range of characters which
+   * was replaced with other characters.
+   */
+  struct text_edit
+  {
+    /** Offset from beginning of the source code where the edit begins. */
+    std::uint64_t offset;
+    /** Number of characters removed from the old source code. */
+    std::uint64_t removed;
+    /** Number of characters inserted into the new source code. */
+    std::uint64_t inserted;
+  };
+}
+
+namespace plorth::parser::ast::internal
+{
+  /**
+   * Moves tokens which appear after an edited range of source code to
+   * their positions in the edited source code.
+   */
+  struct position_shift
+  {
+    /** Difference between the new and the old offsets. */
+    std::int64_t offset;
+    /** Difference between the new and the old line numbers. */
+    std::int64_t line;
+    /**
+     * Old line number of the line the edit ended on. Only columns of tokens
+     * on that line change.
+     */
+    std::int64_t column_line;
+    /** Difference between the new and the old columns on that line. */
+    std::int64_t column;
+
+    void operator()(token& token) const
+    {
+      auto& position = token.m_position;
+
+      if (position.line == column_line)
+      {
+        position.column += column;
+      }
+      position.line += line;
+      position.offset += offset;
+      if (token.m_end)
+      {
+        token.m_end += offset;
+      }
+    }
+
+    /**
+     * Shifts given token and every token nested inside it.
+     */
+    void apply(const std::shared_ptr<token>& root) const
+    {
+      pre_order_traversal traversal(root);
+
+      for (const auto& token : traversal)
+      {
+        if (!token)
+        {
+          continue;
+        }
+        (*this)(*token);
+      }
+    }
+  };
+}
+
+namespace plorth::parser
+{
+  namespace internal
+  {
+    /**
+     * Array, object or quote enclosing an edit, along with it's index in
+     * the enclosing container or the top level tokens.
+     */
+    struct enclosing_token
+    {
+      std::shared_ptr<ast::token> token;
+      std::size_t index;
+    };
+
+    inline std::size_t child_count(const ast::token& parent)
+    {
+      switch (parent.type())
+      {
+        case ast::token::type::array:
+          return static_cast<const ast::array&>(parent).elements().size();
+
+        case ast::token::type::object:
+          return static_cast<const ast::object&>(parent).properties().size();
+
+        case ast::token::type::quote:
+          return static_cast<const ast::quote&>(parent).children().size();
+
+        default:
+          return 0;
+      }
+    }
+
+    inline const std::shared_ptr<ast::token>& child(
+      const ast::token& parent,
+      std::size_t index
+    )
+    {
+      switch (parent.type())
+      {
+        case ast::token::type::array:
+          return static_cast<const ast::array&>(parent).elements()[index];
+
+        case ast::token::type::object:
+          return static_cast<const ast::object&>(parent)
+            .properties()[index].second;
+
+        default:
+          return static_cast<const ast::quote&>(parent).children()[index];
+      }
+    }
+
+    inline std::uint64_t shift_offset(std::uint64_t offset, std::int64_t delta)
+    {
+      return static_cast<std::uint64_t>(static_cast<std::int64_t>(offset)
+        + delta);
+    }
+
+    /**
+     * Advances given position over the source code until it reaches given
+     * offset.
+     */
+    inline void advance_to(
+      struct position& position,
+      const char32_t* current,
+      std::uint64_t offset
+    )
+    {
+      while (position.offset < offset)
+      {
+        utils::advance(current, position);
+      }
+    }
+
+    /**
+     * Returns the position at the end of given token, found by advancing
+     * from the last token nested inside it, so that only the closing
+     * brackets and whitespace after it are scanned.
+     */
+    inline struct position end_position(
+      const std::shared_ptr<ast::token>& token,
+      const char32_t* source,
+      std::uint64_t base
+    )
+    {
+      const ast::token* last = token.get();
+
+      for (;;)
+      {
+        const ast::token* next = nullptr;
+
+        if (last->type() == ast::token::type::word)
+        {
+          next = static_cast<const ast::word&>(*last).symbol().get();
+        }
+        else if (const auto count = child_count(*last))
+        {
+          next = child(*last, count - 1).get();
+        }
+        if (!next)
+        {
+          break;
+        }
+        last = next;
+      }
+
+      auto position = last->position();
+
+      advance_to(
+        position,
+        source + (position.offset - base),
+        token->span().end
+      );
+
+      return position;
+    }
+
+    /**
+     * Constructs copy of given array, object or quote where the child at
+     * given index has been replaced and the end has been moved.
+     */
+    template<class BuilderT>
+    std::shared_ptr<ast::token> replace_child(
+      const ast::token& parent,
+      std::size_t index,
+      std::shared_ptr<ast::token>&& replacement,
+      std::int64_t delta,
+      const BuilderT& builder
+    )
+    {
+      const auto end = shift_offset(parent.span().end, delta);
+
+      switch (parent.type())
+      {
+        case ast::token::type::array:
+        {
+          auto elements = static_cast<const ast::array&>(parent).elements();
+
+          elements[index] = std::move(replacement);
+
+          return builder.make_array(
+            parent.position(),
+            end,
+            std::move(elements)
+          );
+        }
+
+        case ast::token::type::object:
+        {
+          auto properties = static_cast<const ast::object&>(parent)
+            .properties();
+
+          properties[index].second = std::move(replacement);
+
+          return builder.make_object(
+            parent.position(),
+            end,
+            std::move(properties)
+          );
+        }
+
+        default:
+        {
+          auto children = static_cast<const ast::quote&>(parent).children();
+
+          children[index] = std::move(replacement);
+
+          return builder.make_quote(
+            parent.position(),
+            end,
+            std::move(children)
+          );
+        }
+      }
+    }
+
+    /**
+     * Returns the position shift which moves given old token, which appears
+     * after the edit, into given new position.
+     */
+    inline ast::internal::position_shift make_shift(
+      const ast::token& token,
+      const struct position& position
+    )
+    {
+      const auto& old_position = token.position();
+
+      return {
+        static_cast<std::int64_t>(position.offset)
+          - static_cast<std::int64_t>(old_position.offset),
+        position.line - old_position.line,
+        old_position.line,
+        position.column - old_position.column
+      };
+    }
+  }
+
+  /**
+   * Updates AST of a Plorth program after an edit has been made to it's
+   * source code, reusing every token which is not affected by the edit
+   * instead of parsing the whole program again.
+   *
+   * Only the innermost array, object or quote which encloses the edit is
+   * parsed again. If the edit changes where it ends, for example by
+   * inserting a closing bracket, the container enclosing it is tried
+   * instead. Edits between top level tokens are handled by parsing the
+   * top level tokens from the one preceding the edit until the tokens
+   * after the edit are reached. The result is the same as if the new source
+   * code had been parsed with parse().
+   *
+   * Tokens after the edit are moved to their new positions in place, so
+   * the old AST must not be used afterwards, and must not be accessed
+   * from other threads while this function runs. If the old AST has
+   * string literals or symbols referring to the source code, or lazy
+   * quotes, the reused tokens keep referring to the old source code, which
+   * must then outlive them.
+   *
+   * \param tokens   AST of the old source code, as returned by parse() or by
+   *                 a previous call to this function.
+   * \param source   The new source code, which must be stored in contiguous
+   *                 memory.
+   * \param edit     The edit which turned the old source code into the new
+   *                 one. Offsets are relative to beginning of the source
+   *                 code.
+   * \param position Position at the beginning of the source code, which
+   *                 was also used to parse the old source code.
+   * \param builder  Builder used to construct the AST tokens.
+   */
+  template<class BuilderT = ast::builder<>>
+  basic_parse_result<BuilderT> reparse(
+    const std::vector<std::shared_ptr<ast::token>>& tokens,
+    const std::u32string_view& source,
+    const text_edit& edit,
+    const struct position& position,
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    static_assert(
+      std::is_same_v<
+        typename BuilderT::token_type,
+        std::shared_ptr<ast::token>
+      >,
+      "Only AST tokens can be reparsed."
+    );
+    using result_type = basic_parse_result<BuilderT>;
+    const auto base = position.offset;
+    const auto delta = static_cast<std::int64_t>(edit.inserted)
+      - static_cast<std::int64_t>(edit.removed);
+    const auto edit_begin = base + edit.offset;
+    const auto old_edit_end = edit_begin + edit.removed;
+    const auto new_edit_end = edit_begin + edit.inserted;
+    const auto begin = source.data();
+    const auto end = begin + source.length();
+    const auto child_at = [&tokens](const ast::token* parent, std::size_t i)
+      -> const std::shared_ptr<ast::token>&
+    {
+      return parent ? internal::child(*parent, i) : tokens[i];
+    };
+    std::vector<internal::enclosing_token> path;
+
+    // Find the containers whose brackets enclose the edit, from the
+    // outermost to the innermost one.
+    for (const ast::token* parent = nullptr;;)
+    {
+      std::size_t low = 0;
+      std::size_t high = parent
+        ? internal::child_count(*parent)
+        : tokens.size();
+
+      // Last token which begins before the edit.
+      while (low < high)
+      {
+        const auto middle = low + (high - low) / 2;
+        const auto& token = child_at(parent, middle);
+
+        if (token && token->position().offset < edit_begin)
+        {
+          low = middle + 1;
+        } else {
+          high = middle;
+        }
+      }
+      if (!low)
+      {
+        break;
+      }
+
+      const auto& token = child_at(parent, low - 1);
+
+      if (!token
+          || !internal::child_count(*token)
+          || old_edit_end >= token->span().end)
+      {
+        break;
+      }
+      path.push_back({ token, low - 1 });
+      parent = token.get();
+    }
+
+    for (auto depth = path.size(); depth-- > 0;)
+    {
+      const auto& container = path[depth].token;
+      auto current = begin + (container->position().offset - base);
+      auto new_position = container->position();
+      auto result = parse_token(current, end, new_position, builder);
+      const ast::token* following = nullptr;
+
+      if (!result || new_position.offset != internal::shift_offset(
+        container->span().end,
+        delta
+      ))
+      {
+        continue;
+      }
+
+      // Find the first token after the container, to determine how much
+      // the tokens after the edit move.
+      for (auto i = depth + 1; i-- > 0 && !following;)
+      {
+        const auto parent = i > 0 ? path[i - 1].token.get() : nullptr;
+        const auto count = parent
+          ? internal::child_count(*parent)
+          : tokens.size();
+
+        for (auto j = path[i].index + 1; j < count && !following; ++j)
+        {
+          following = child_at(parent, j).get();
+        }
+      }
+      if (following)
+      {
+        internal::advance_to(
+          new_position,
+          current,
+          internal::shift_offset(following->position().offset, delta)
+        );
+
+        const auto shift = internal::make_shift(*following, new_position);
+
+        for (auto i = depth + 1; i-- > 0;)
+        {
+          const auto parent = i > 0 ? path[i - 1].token.get() : nullptr;
+          const auto count = parent
+            ? internal::child_count(*parent)
+            : tokens.size();
+
+          for (auto j = path[i].index + 1; j < count; ++j)
+          {
+            shift.apply(child_at(parent, j));
+          }
+        }
+      }
+
+      // Replace the container and every container enclosing it.
+      auto replacement = std::move(*result);
+      auto result_tokens = tokens;
+
+      for (auto i = depth; i > 0; --i)
+      {
+        replacement = internal::replace_child(
+          *path[i - 1].token,
+          path[i].index,
+          std::move(replacement),
+          delta,
+          builder
+        );
+      }
+      result_tokens[path[0].index] = std::move(replacement);
+
+      return result_type::ok(std::move(result_tokens));
+    }
+
+    // The edit is not enclosed by any container, so parse the top level
+    // tokens around it, beginning from the last one which ends before the
+    // edit.
+    std::size_t index = 0;
+    std::vector<std::shared_ptr<ast::token>> result_tokens;
+    auto new_position = position;
+    auto current = begin;
+
+    while (index < tokens.size()
+        && tokens[index]
+        && tokens[index]->span().end < edit_begin)
+    {
+      ++index;
+    }
+    if (index > 0)
+    {
+      new_position = internal::end_position(tokens[index - 1], begin, base);
+      current = begin + (new_position.offset - base);
+    }
+    result_tokens.assign(std::begin(tokens), std::begin(tokens) + index);
+
+    while (current < end)
+    {
+      utils::skip_whitespace(current, end, new_position);
+
+      // Tokens after the edit can be reused once parsing reaches one of
+      // them, as the source code after the edit has not changed.
+      if (current < end && new_position.offset >= new_edit_end)
+      {
+        const auto old_offset = internal::shift_offset(
+          new_position.offset,
+          -delta
+        );
+
+        while (index < tokens.size()
+            && (!tokens[index]
+              || tokens[index]->position().offset < old_offset))
+        {
+          ++index;
+        }
+        if (index < tokens.size()
+            && tokens[index]->position().offset == old_offset)
+        {
+          const auto shift = internal::make_shift(
+            *tokens[index],
+            new_position
+          );
+
+          for (; index < tokens.size(); ++index)
+          {
+            shift.apply(tokens[index]);
+            result_tokens.push_back(tokens[index]);
+          }
+
+          return result_type::ok(std::move(result_tokens));
+        }
+      }
+
+      auto token = parse_token(current, end, new_position, builder);
+
+      if (!token)
+      {
+        return result_type::error(token.error());
+      }
+      result_tokens.push_back(std::move(*token));
+    }
+
+    return result_type::ok(std::move(result_tokens));
+  }
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace plorth::parser
+{
+  class symbol_table;
+
+  /**
+   * Immutable string which is cheap to copy. Strings short enough to fit
+   * into the small string buffer of std::u32string are stored inline, like
+   * std::u32string would store them, so constructing or copying them does
+   * not allocate. Copies of longer strings share the same character data.
+   *
+   * Strings obtained from a symbol table are never stored inline, and the
+   * table returns the same character data for equal text, so two strings
+   * interned by the same table are compared by their identity only. Strings
+   * which have not been interned, or which have been interned by different
+   * tables, are compared by their text.
+   */
+  class interned_string
+  {
+    friend class symbol_table;
+
+  public:
+    using value_type = std::u32string;
+
+    interned_string() = default;
+
+    interned_string(const value_type& value)
+      : m_value(store(value_type(value))) {}
+
+    interned_string(value_type&& value)
+      : m_value(store(std::move(value))) {}
+
+    interned_string(const char32_t* value)
+      : m_value(store(value_type(value))) {}
+
+    /**
+     * Returns the text contents of the string.
+     */
+    inline const value_type& str() const
+    {
+      if (const auto shared = std::get_if<shared_type>(&m_value))
+      {
+        return (*shared)->value;
+      }
+
+      return std::get<value_type>(m_value);
+    }
+
+    inline operator const value_type&() const
+    {
+      return str();
+    }
+
+    inline operator std::u32string_view() const
+    {
+      return str();
+    }
+
+    /**
+     * Returns an identifier of the character data of the string, which is
+     * shared by copies of the string unless the string is stored inline. All
+     * strings interned by the same symbol table have the same identifier if,
+     * and only if, they are equal.
+     */
+    inline const void* id() const
+    {
+      return &str();
+    }
+
+    /**
+     * Returns true if the string has been interned by a symbol table.
+     */
+    inline bool is_interned() const
+    {
+      return table() != 0;
+    }
+
+    inline bool empty() const
+    {
+      return str().empty();
+    }
+
+    inline std::size_t length() const
+    {
+      return str().length();
+    }
+
+    inline bool operator==(const interned_string& that) const
+    {
+      if (id() == that.id())
+      {
+        return true;
+      }
+      // Same table never interns equal text twice.
+      if (table() && table() == that.table())
+      {
+        return false;
+      }
+
+      return str() == that.str();
+    }
+
+    inline bool operator!=(const interned_string& that) const
+    {
+      return !(*this == that);
+    }
+
+    inline bool operator<(const interned_string& that) const
+    {
+      return str() < that.str();
+    }
+
+    inline bool operator==(const value_type& that) const
+    {
+      return str() == that;
+    }
+
+    inline bool operator!=(const value_type& that) const
+    {
+      return str() != that;
+    }
+
+    inline bool operator==(const char32_t* that) const
+    {
+      return str() == that;
+    }
+
+    inline bool operator!=(const char32_t* that) const
+    {
+      return str() != that;
+    }
+
+    friend inline bool operator==(
+      const value_type& a,
+      const interned_string& b
+    )
+    {
+      return b == a;
+    }
+
+    friend inline bool operator!=(
+      const value_type& a,
+      const interned_string& b
+    )
+    {
+      return b != a;
+    }
+
+    friend inline bool operator==(
+      const char32_t* a,
+      const interned_string& b
+    )
+    {
+      return b == a;
+    }
+
+    friend inline bool operator!=(
+      const char32_t* a,
+      const interned_string& b
+    )
+    {
+      return b != a;
+    }
+
+  private:
+    struct shared_value
+    {
+      value_type value;
+      /** Identifier of the table which interned the string, or zero. */
+      std::uint64_t table;
+    };
+
+    using shared_type = std::shared_ptr<const shared_value>;
+    using storage_type = std::variant<value_type, shared_type>;
+
+    interned_string(value_type&& value, std::uint64_t table)
+      : m_value(std::make_shared<const shared_value>(
+          shared_value{ std::move(value), table }
+        )) {}
+
+    inline std::uint64_t table() const
+    {
+      if (const auto shared = std::get_if<shared_type>(&m_value))
+      {
+        return (*shared)->table;
+      }
+
+      return 0;
+    }
+
+    static storage_type store(value_type&& value)
+    {
+      if (value.length() <= value_type().capacity())
+      {
+        return storage_type(std::in_place_type<value_type>, std::move(value));
+      }
+
+      return std::make_shared<const shared_value>(
+        shared_value{ std::move(value), 0 }
+      );
+    }
+
+    storage_type m_value;
+  };
+}
+
+namespace std
+{
+  template<>
+  struct hash<plorth::parser::interned_string>
+  {
+    std::size_t operator()(
+      const plorth::parser::interned_string& value
+    ) const
+    {
+      return std::hash<std::u32string_view>()(value);
+    }
+  };
+}
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <plorth/parser/events.hpp>
+
+namespace plorth::parser
+{
+  namespace internal
+  {
+    /**
+     * Event handler which constructs values with a builder, keeping contents
+     * of currently open arrays, objects and quotes in stacks allocated from
+     * the heap.
+     */
+    template<class IteratorT, class BuilderT>
+    class tree_handler
+    {
+    public:
+      using token_type = typename BuilderT::token_type;
+      using key_type = decltype(std::declval<const BuilderT&>().make_key(
+        std::declval<const struct position&>(),
+        std::uint64_t(),
+        std::declval<std::u32string&&>()
+      ));
+
+      explicit tree_handler(const BuilderT& builder)
+        : m_builder(builder)
+      {
+        reserve(m_builder, m_tokens);
+      }
+
+      inline void on_array_begin(const struct position& position)
+      {
+        m_brackets.push_back(U'[');
+        m_arrays.emplace_back();
+        reserve(m_builder, m_arrays.back(), &position);
+      }
+
+      inline void on_array_end(
+        const struct position& position,
+        std::uint64_t end
+      )
+      {
+        auto elements = std::move(m_arrays.back());
+
+        m_arrays.pop_back();
+        m_brackets.pop_back();
+        add(m_builder.make_array(position, end, std::move(elements)));
+      }
+
+      inline void on_object_begin(const struct position& position)
+      {
+        m_brackets.push_back(U'{');
+        m_objects.emplace_back();
+        reserve(m_builder, m_objects.back(), &position);
+      }
+
+      inline void on_object_key(
+        const struct position& position,
+        std::uint64_t end,
+        string_literal& key
+      )
+      {
+        m_keys.push_back(
+          make_key<IteratorT>(m_builder, position, end, std::move(key))
+        );
+      }
+
+      inline void on_object_end(
+        const struct position& position,
+        std::uint64_t end
+      )
+      {
+        auto properties = std::move(m_objects.back());
+
+        m_objects.pop_back();
+        m_brackets.pop_back();
+        add(m_builder.make_object(position, end, std::move(properties)));
+      }
+
+      inline void on_quote_begin(const struct position& position)
+      {
+        m_brackets.push_back(U'(');
+        m_quotes.emplace_back();
+        reserve(m_builder, m_quotes.back(), &position);
+      }
+
+      inline void on_quote_end(
+        const struct position& position,
+        std::uint64_t end
+      )
+      {
+        auto children = std::move(m_quotes.back());
+
+        m_quotes.pop_back();
+        m_brackets.pop_back();
+        add(m_builder.make_quote(position, end, std::move(children)));
+      }
+
+      inline void on_string(
+        const struct position& position,
+        std::uint64_t end,
+        string_literal& value
+      )
+      {
+        add(
+          make_string<IteratorT>(m_builder, position, end, std::move(value))
+        );
+      }
+
+      inline void on_symbol(
+        const struct position& position,
+        std::uint64_t end,
+        string_literal& id
+      )
+      {
+        add(make_symbol<IteratorT>(m_builder, position, end, std::move(id)));
+      }
+
+      inline void on_word(
+        const struct position& position,
+        std::uint64_t end,
+        const struct position& symbol_position,
+        string_literal& id
+      )
+      {
+        add(m_builder.make_word(
+          position,
+          end,
+          make_symbol<IteratorT>(
+            m_builder,
+            symbol_position,
+            end,
+            std::move(id)
+          )
+        ));
+      }
+
+      /**
+       * Returns the constructed top level values.
+       */
+      inline std::vector<token_type>& tokens()
+      {
+        return m_tokens;
+      }
+
+    private:
+      /**
+       * Adds completed value into the innermost open container, or into the
+       * top level values if there is none.
+       */
+      void add(token_type&& value)
+      {
+        if (m_brackets.empty())
+        {
+          m_tokens.push_back(std::move(value));
+        }
+        else if (m_brackets.back() == U'[')
+        {
+          m_arrays.back().push_back(std::move(value));
+        }
+        else if (m_brackets.back() == U'(')
+        {
+          m_quotes.back().push_back(std::move(value));
+        } else {
+          m_objects.back().emplace_back(
+            std::move(m_keys.back()),
+            std::move(value)
+          );
+          m_keys.pop_back();
+        }
+      }
+
+    private:
+      const BuilderT& m_builder;
+      std::vector<token_type> m_tokens;
+      /** Opening brackets of currently open containers. */
+      std::vector<char32_t> m_brackets;
+      std::vector<typename BuilderT::array_container_type> m_arrays;
+      std::vector<typename BuilderT::object_container_type> m_objects;
+      std::vector<typename BuilderT::quote_container_type> m_quotes;
+      /** Keys of object properties whose values are being parsed. */
+      std::vector<key_type> m_keys;
+    };
+  }
+
+  /**
+   * Attempts to parse an entire Plorth program, like parse(), but without
+   * recursion. Contents of nested arrays, objects and quotes are kept in
+   * stacks allocated from the heap, so deeply nested input cannot overflow
+   * the call stack. Returns the same values and errors as parse(). AST
+   * tokens destroy the tokens nested inside them without recursion as well,
+   * so the result can be released no matter how deep it is.
+   *
+   * \param current   Iterator pointing to current position in source code.
+   * \param end       Iterator pointing to end of the source code.
+   * \param position  Current source code position.
+   * \param builder   Builder used to construct the AST tokens.
+   * \param max_depth Maximum number of nested arrays, objects and quotes.
+   *                  Deeper nesting is reported as an error.
+   */
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_result<BuilderT> parse_iterative(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position,
+    const BuilderT& builder = BuilderT(),
+    std::size_t max_depth = std::numeric_limits<std::size_t>::max()
+  )
+  {
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    using result_type = basic_parse_result<BuilderT>;
+    internal::tree_handler<IteratorT, BuilderT> handler(builder);
+
+    if (auto parse_error = internal::parse_events<true>(
+      current,
+      end,
+      position,
+      handler,
+      max_depth
+    ))
+    {
+      return result_type::error(std::move(*parse_error));
+    }
+
+    return result_type::ok(std::move(handler.tokens()));
+  }
+
+  /**
+   * Attempts to parse an entire Plorth program from UTF-8 encoded source code
+   * without recursion.
+   *
+   * \param source    UTF-8 encoded source code.
+   * \param position  Current source code position.
+   * \param builder   Builder used to construct the AST tokens.
+   * \param max_depth Maximum number of nested arrays, objects and quotes.
+   *                  Deeper nesting is reported as an error.
+   */
+  template<class BuilderT = ast::builder<>>
+  basic_parse_result<BuilderT> parse_iterative(
+    const std::string_view& source,
+    struct position& position,
+    const BuilderT& builder = BuilderT(),
+    std::size_t max_depth = std::numeric_limits<std::size_t>::max()
+  )
+  {
+    auto current = utf8::begin(source);
+    const auto end = utf8::end(source);
+
+    return parse_iterative(current, end, position, builder, max_depth);
+  }
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <optional>
+
+#include <plorth/parser/events.hpp>
+
+namespace plorth::parser::ast
+{
+  namespace internal
+  {
+    /**
+     * Range of source code occupied by a quote which has already been
+     * checked to be valid, given as offsets of the opening parenthesis and
+     * of the character following the closing one.
+     */
+    struct validated_quote
+    {
+      std::uint64_t begin;
+      std::uint64_t end;
+    };
+
+    using validated_quotes = std::vector<validated_quote>;
+
+    /**
+     * Event handler which records ranges of the quotes nested inside the
+     * quote being checked, ordered by their beginnings.
+     */
+    struct quote_recorder : public event_handler
+    {
+      inline void on_quote_begin(const struct position& position)
+      {
+        // The outermost quote is not recorded, so that quotes without any
+        // nested quotes do not allocate anything.
+        if (depth++ > 0)
+        {
+          open.push_back(quotes.size());
+          quotes.push_back({ position.offset, 0 });
+        }
+      }
+
+      inline void on_quote_end(const struct position&, std::uint64_t end)
+      {
+        if (--depth > 0)
+        {
+          quotes[open.back()].end = end;
+          open.pop_back();
+        }
+      }
+
+      std::size_t depth = 0;
+      std::vector<std::size_t> open;
+      validated_quotes quotes;
+    };
+  }
+
+  /**
+   * Builder which constructs lazy quotes: instead of parsing the children of
+   * a quote, the parser only checks that the quote is syntactically valid
+   * and finds where it ends, and the children are parsed when they are
+   * accessed for the first time. This makes loading of large programs, most
+   * of which consists of word definitions that are never executed, both
+   * faster and use less memory.
+   *
+   * Quotes nested inside a lazy quote are lazy as well. Ranges of them are
+   * recorded when the outermost quote is checked, so when a quote has it's
+   * children parsed, the quotes nested inside it are skipped over without
+   * checking them again. Errors are reported when the quote is first
+   * encountered, exactly as parse() would report them, so parsing the
+   * children later cannot fail.
+   *
+   * Children of different quotes may be parsed from different threads at
+   * the same time, so the allocator must be stateless and the symbol table,
+   * if one is used, must be thread safe. If the symbol table is not, quotes
+   * are parsed eagerly instead, just like with the regular AST builder. The
+   * source code must outlive the AST tokens, and so must the symbol table,
+   * as the children may be parsed at any time.
+   */
+  template<class AllocatorT = std::allocator<token>>
+  class lazy_builder : public builder<AllocatorT>
+  {
+  public:
+    static_assert(
+      std::allocator_traits<AllocatorT>::is_always_equal::value,
+      "Lazy quotes may allocate from multiple threads at any time, so the "
+      "allocator must be stateless."
+    );
+
+    using builder<AllocatorT>::builder;
+
+    template<class IteratorT>
+    basic_parse_quote_result<lazy_builder> make_lazy_quote(
+      IteratorT& current,
+      const IteratorT& end,
+      struct position& position
+    ) const
+    {
+      using result_type = basic_parse_quote_result<lazy_builder>;
+      const auto begin = current;
+      const auto quote_position = position;
+
+      if (this->symbol_table() && !this->symbol_table()->thread_safe())
+      {
+        return parser::parse_quote(
+          current,
+          end,
+          position,
+          static_cast<const builder<AllocatorT>&>(*this)
+        );
+      }
+
+      if (const auto quote_end = validated_end(position.offset))
+      {
+        skip(current, position, *quote_end);
+
+        return result_type::ok(make_unloaded_quote(
+          *this,
+          begin,
+          current,
+          quote_position,
+          position.offset
+        ));
+      }
+
+      internal::quote_recorder recorder;
+      parser::internal::event_adapter<internal::quote_recorder>
+        adapter(recorder);
+
+      if (auto error = parser::internal::parse_events<false>(
+        current,
+        end,
+        position,
+        adapter,
+        std::numeric_limits<std::size_t>::max(),
+        true
+      ))
+      {
+        return result_type::error(*error);
+      }
+
+      auto children_builder = *this;
+
+      if (!recorder.quotes.empty())
+      {
+        children_builder.m_validated = std::make_shared<
+          const internal::validated_quotes
+        >(std::move(recorder.quotes));
+      }
+
+      return result_type::ok(make_unloaded_quote(
+        children_builder,
+        begin,
+        current,
+        quote_position,
+        position.offset
+      ));
+    }
+
+  private:
+    /**
+     * Constructs lazy quote whose children are parsed with given builder.
+     */
+    template<class IteratorT>
+    typename builder<AllocatorT>::quote_type make_unloaded_quote(
+      const lazy_builder& children_builder,
+      const IteratorT& begin,
+      const IteratorT& end,
+      const struct position& quote_position,
+      std::uint64_t end_offset
+    ) const
+    {
+      return std::allocate_shared<lazy_quote>(
+        this->get_allocator(),
+        quote_position,
+        [builder = children_builder, begin, end, quote_position]()
+        {
+          return builder.parse_children(begin, end, quote_position);
+        },
+        end_offset
+      );
+    }
+
+    /**
+     * Returns offset of the end of a quote beginning at given offset, if
+     * it's nested inside a quote which has already been checked.
+     */
+    std::optional<std::uint64_t> validated_end(std::uint64_t offset) const
+    {
+      if (m_validated)
+      {
+        const auto it = std::lower_bound(
+          std::begin(*m_validated),
+          std::end(*m_validated),
+          offset,
+          [](const internal::validated_quote& quote,
+             std::uint64_t offset)
+          {
+            return quote.begin < offset;
+          }
+        );
+
+        if (it != std::end(*m_validated) && it->begin == offset)
+        {
+          return it->end;
+        }
+      }
+
+      return std::nullopt;
+    }
+
+    /**
+     * Advances to given offset over source code which has already been
+     * checked, keeping track of the position.
+     */
+    template<class IteratorT>
+    static void skip(
+      IteratorT& current,
+      struct position& position,
+      std::uint64_t offset
+    )
+    {
+      if constexpr (utils::is_contiguous_v<IteratorT>)
+      {
+        const auto end = current + (offset - position.offset);
+
+        while (current < end)
+        {
+          utils::advance_run(
+            current,
+            end,
+            position,
+            scan::find_line_end,
+            scan::ascii::find_line_end
+          );
+          if (current < end)
+          {
+            utils::advance(current, position);
+          }
+        }
+      } else {
+        while (position.offset < offset)
+        {
+          utils::advance(current, position);
+        }
+      }
+    }
+
+    /**
+     * Parses children of a quote which has already been checked to be
+     * valid.
+     */
+    template<class IteratorT>
+    quote::container_type parse_children(
+      IteratorT current,
+      const IteratorT& end,
+      struct position position
+    ) const
+    {
+      const auto quote_position = position;
+      quote::container_type children;
+
+      utils::advance(current, position);
+      parser::internal::reserve(*this, children, &quote_position);
+      while (!utils::skip_whitespace(current, end, position)
+          && !utils::peek_advance(current, end, position, U')'))
+      {
+        auto child_result = parser::parse_token(
+          current,
+          end,
+          position,
+          *this
+        );
+
+        if (!child_result)
+        {
+          break;
+        }
+        children.push_back(std::move(*child_result));
+      }
+
+      return children;
+    }
+
+    /** Quotes nested inside the quote being parsed, already checked. */
+    std::shared_ptr<const internal::validated_quotes> m_validated;
+  };
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include <plorth/parser/position.hpp>
+#include <plorth/parser/utf8.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Index of line beginnings in source code, which is used to convert
+   * offsets recorded in source spans into line and column numbers. The
+   * parser does not build one; it's meant to be constructed only once a
+   * diagnostic or a tool actually needs line numbers.
+   *
+   * The index refers to the source code it was built from, so the source
+   * code must outlive the index.
+   */
+  template<class CharT>
+  class basic_line_index
+  {
+  public:
+    using string_view_type = std::basic_string_view<CharT>;
+
+    /**
+     * Builds line index for given source code.
+     */
+    explicit basic_line_index(const string_view_type& source)
+      : m_source(source)
+    {
+      const auto begin = source.data();
+      const auto end = begin + source.length();
+
+      m_line_starts.push_back(0);
+      for (auto current = begin; current < end; ++current)
+      {
+        current = find_newline(current, end);
+        if (current == end)
+        {
+          break;
+        }
+        m_line_starts.push_back(current - begin + 1);
+      }
+    }
+
+    /**
+     * Returns number of lines in the source code.
+     */
+    inline std::size_t line_count() const
+    {
+      return m_line_starts.size();
+    }
+
+    /**
+     * Returns offset of beginning of given line. Lines are numbered starting
+     * from one.
+     */
+    inline std::uint64_t line_start(std::int64_t line) const
+    {
+      return m_line_starts[line - 1];
+    }
+
+    /**
+     * Converts given offset into a position in the source code. Columns are
+     * counted in code points, so they match the columns computed by the
+     * parser. Malformed UTF-8 is counted like the decoder used by the parser
+     * decodes it, as one replacement character per byte.
+     *
+     * \param offset Offset from beginning of the source code.
+     * \param file   Name of the file to include in the position.
+     */
+    struct position locate(
+      std::uint64_t offset,
+      const interned_string& file = interned_string()
+    ) const
+    {
+      const auto it = std::upper_bound(
+        std::begin(m_line_starts),
+        std::end(m_line_starts),
+        offset
+      ) - 1;
+      const auto begin = m_source.data() + *it;
+      const auto end = m_source.data() + std::min<std::uint64_t>(
+        offset,
+        m_source.length()
+      );
+      std::int64_t column = 1;
+
+      if constexpr (sizeof(CharT) == 1)
+      {
+        const auto source_end = m_source.data() + m_source.length();
+
+        for (auto current = begin; current < end; ++column)
+        {
+          std::size_t length;
+
+          utf8::decode(current, source_end, length);
+          current += length;
+        }
+      } else {
+        column += end - begin;
+      }
+
+      return {
+        file,
+        static_cast<std::int64_t>(it - std::begin(m_line_starts)) + 1,
+        column,
+        offset
+      };
+    }
+
+  private:
+    static inline const CharT* find_newline(
+      const CharT* current,
+      const CharT* end
+    )
+    {
+      if constexpr (sizeof(CharT) == 1)
+      {
+        const auto result = std::memchr(current, '\n', end - current);
+
+        return result ? static_cast<const CharT*>(result) : end;
+      } else {
+        return std::find(current, end, CharT('\n'));
+      }
+    }
+
+    string_view_type m_source;
+    std::vector<std::uint64_t> m_line_starts;
+  };
+
+  /**
+   * Line index for UTF-8 encoded source code.
+   */
+  using line_index = basic_line_index<char>;
+
+  /**
+   * Line index for UTF-32 encoded source code.
+   */
+  using u32line_index = basic_line_index<char32_t>;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <plorth/parser/ast.hpp>
+#include <plorth/parser/thread_pool.hpp>
+
+namespace plorth::parser::ast
+{
+  namespace internal
+  {
+    /**
+     * Range of subtrees processed by a single task.
+     */
+    struct subtree_chunk
+    {
+      std::size_t begin;
+      std::size_t end;
+    };
+
+    /**
+     * Divides given subtrees into at most given number of consecutive
+     * chunks of roughly equal amount of work. Length of the source code a
+     * subtree was parsed from is used as estimate of it's size, as counting
+     * the tokens would require traversing the whole tree.
+     */
+    inline std::vector<subtree_chunk> split_subtrees(
+      const std::vector<std::shared_ptr<token>>& subtrees,
+      std::size_t max_chunks
+    )
+    {
+      const auto weight = [](const std::shared_ptr<token>& subtree)
+      {
+        return subtree
+          ? std::max<std::uint64_t>(subtree->span().length(), 1)
+          : 1;
+      };
+      std::vector<subtree_chunk> chunks;
+      std::uint64_t total = 0;
+      std::uint64_t accumulated = 0;
+      std::size_t begin = 0;
+
+      for (const auto& subtree : subtrees)
+      {
+        total += weight(subtree);
+      }
+      max_chunks = std::max<std::size_t>(
+        std::min(max_chunks, subtrees.size()),
+        1
+      );
+      chunks.reserve(max_chunks);
+      for (std::size_t i = 0; i < subtrees.size(); ++i)
+      {
+        accumulated += weight(subtrees[i]);
+        // Close the chunk once it's share of the total has been reached.
+        if (accumulated * max_chunks >= total * (chunks.size() + 1))
+        {
+          chunks.push_back({ begin, i + 1 });
+          begin = i + 1;
+        }
+      }
+      if (begin < subtrees.size())
+      {
+        chunks.push_back({ begin, subtrees.size() });
+      }
+
+      return chunks;
+    }
+  }
+
+  /**
+   * Applies given map function to each of given subtrees in parallel, using
+   * the given thread pool, and combines the results with given reduce
+   * function. The subtrees can be for example the result of a parse, or
+   * the elements of a single large array.
+   *
+   * Consecutive subtrees are grouped into chunks, each of which is folded
+   * into a single result by one task, starting from the initial value.
+   * Results of the chunks are then combined in order, so the reduce
+   * function needs to be associative, but not commutative, and the initial
+   * value must be it's identity.
+   *
+   * The AST is not modified after it has been parsed, so it can be read
+   * from multiple threads at the same time without locking. The map
+   * function is called from multiple threads at the same time, so any
+   * state shared by it must be safe to access so.
+   *
+   * \param subtrees Subtrees to process. Null pointers are passed to the
+   *                 map function as they are.
+   * \param pool     Thread pool used to process the subtrees. This function
+   *                 must not be called from a task running in the same
+   *                 pool.
+   * \param init     Identity of the reduce function.
+   * \param map      Function which receives a subtree and returns it's
+   *                 result.
+   * \param reduce   Function which combines two results into one.
+   * \param chunks   Maximum number of chunks to divide the subtrees into,
+   *                 or zero to use four times the number of threads in the
+   *                 pool, which lets idle threads steal work from busy ones
+   *                 when the subtrees differ in size.
+   */
+  template<class ResultT, class MapT, class ReduceT>
+  ResultT parallel_map_reduce(
+    const std::vector<std::shared_ptr<token>>& subtrees,
+    thread_pool& pool,
+    ResultT init,
+    MapT map,
+    ReduceT reduce,
+    std::size_t chunks = 0
+  )
+  {
+    std::vector<std::future<ResultT>> futures;
+
+    if (!chunks)
+    {
+      chunks = pool.size() * 4;
+    }
+    for (const auto& chunk : internal::split_subtrees(subtrees, chunks))
+    {
+      futures.push_back(pool.submit([&, chunk]()
+      {
+        auto result = init;
+
+        for (auto i = chunk.begin; i < chunk.end; ++i)
+        {
+          result = reduce(std::move(result), map(subtrees[i]));
+        }
+
+        return result;
+      }));
+    }
+
+    for (auto& result : parser::internal::wait_all(futures))
+    {
+      init = reduce(std::move(init), std::move(result));
+    }
+
+    return init;
+  }
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+# define PLORTH_PARSER_HAS_MMAP 1
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace plorth::parser
+{
+  /**
+   * Read only view to contents of a file. On POSIX systems the file is
+   * mapped into memory, so that it doesn't have to be copied; on other
+   * systems the file is read into a buffer instead.
+   */
+  class mapped_file
+  {
+  public:
+    /**
+     * Opens given file. Use is_open() to find out whether the file could be
+     * opened.
+     */
+    explicit mapped_file(const std::string& path)
+      : m_data(nullptr)
+      , m_size(0)
+      , m_mapped(false)
+      , m_open(false)
+    {
+#if defined(PLORTH_PARSER_HAS_MMAP)
+      const int fd = ::open(path.c_str(), O_RDONLY);
+      struct ::stat info;
+
+      if (fd < 0)
+      {
+        return;
+      }
+      if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+      {
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (!m_size)
+        {
+          m_open = true;
+        } else {
+          void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+          if (data != MAP_FAILED)
+          {
+            m_data = static_cast<const char*>(data);
+            m_mapped = true;
+            m_open = true;
+          }
+        }
+      }
+      ::close(fd);
+      if (m_open)
+      {
+        return;
+      }
+      m_size = 0;
+#endif
+      std::ifstream stream(path, std::ios::in | std::ios::binary);
+
+      if (stream)
+      {
+        m_buffer.assign(
+          std::istreambuf_iterator<char>(stream),
+          std::istreambuf_iterator<char>()
+        );
+        m_data = m_buffer.data();
+        m_size = m_buffer.length();
+        m_open = !stream.bad();
+      }
+    }
+
+    mapped_file(mapped_file&& that) noexcept
+      : m_data(that.m_data)
+      , m_size(that.m_size)
+      , m_mapped(that.m_mapped)
+      , m_open(that.m_open)
+      , m_buffer(std::move(that.m_buffer))
+    {
+      if (!m_mapped)
+      {
+        m_data = m_buffer.data();
+      }
+      that.m_data = nullptr;
+      that.m_size = 0;
+      that.m_mapped = false;
+      that.m_open = false;
+    }
+
+    ~mapped_file()
+    {
+#if defined(PLORTH_PARSER_HAS_MMAP)
+      if (m_mapped)
+      {
+        ::munmap(const_cast<char*>(m_data), m_size);
+      }
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    void operator=(const mapped_file&) = delete;
+    void operator=(mapped_file&&) = delete;
+
+    /**
+     * Returns true if the file was opened successfully.
+     */
+    inline bool is_open() const
+    {
+      return m_open;
+    }
+
+    /**
+     * Returns true if the file is mapped into memory instead of being copied
+     * into a buffer.
+     */
+    inline bool is_mapped() const
+    {
+      return m_mapped;
+    }
+
+    inline const char* data() const
+    {
+      return m_data;
+    }
+
+    inline std::size_t size() const
+    {
+      return m_size;
+    }
+
+    /**
+     * Returns contents of the file.
+     */
+    inline std::string_view view() const
+    {
+      return std::string_view(m_data ? m_data : "", m_size);
+    }
+
+  private:
+    const char* m_data;
+    std::size_t m_size;
+    bool m_mapped;
+    bool m_open;
+    std::string m_buffer;
+  };
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+
+#include <plorth/parser/structural_index.hpp>
+#include <plorth/parser/thread_pool.hpp>
+
+namespace plorth::parser
+{
+  namespace internal
+  {
+    /**
+     * Range of source code parsed by a single task.
+     */
+    struct chunk
+    {
+      std::size_t begin;
+      std::size_t end;
+      struct position position;
+    };
+
+    /**
+     * Returns the position at the end of given source code, when it begins
+     * at given position.
+     */
+    inline struct position advance_position(
+      struct position position,
+      const std::u32string_view& source
+    )
+    {
+      position.offset += source.length();
+#if !defined(PLORTH_PARSER_OFFSETS_ONLY)
+      const auto last_line_feed = source.rfind(U'\n');
+
+      if (last_line_feed == std::u32string_view::npos)
+      {
+        position.column += source.length();
+      } else {
+        position.line += std::count(
+          std::begin(source),
+          std::end(source),
+          U'\n'
+        );
+        position.column = source.length() - last_line_feed;
+      }
+#endif
+
+      return position;
+    }
+
+    /**
+     * Returns true if given source code contains nothing but whitespace and
+     * comments.
+     */
+    inline bool blank(const std::u32string_view& source)
+    {
+      auto current = source.data();
+      const auto end = current + source.length();
+      struct position position;
+
+      return utils::skip_whitespace(current, end, position);
+    }
+
+    /**
+     * Splits the source code into chunks of whole top level values, which
+     * can be parsed independently of each other. The first chunk begins at
+     * the beginning of the source code, so that leading whitespace is
+     * handled exactly like by the sequential parser, and the last one ends
+     * at the end of it, for the same reason. Other chunks end where their
+     * last value ends, since the parser rejects trailing whitespace.
+     *
+     * Source code between the chunks is not parsed, so it's checked here to
+     * contain only whitespace and comments. If it does not, no chunks are
+     * returned and the source code must be parsed sequentially.
+     */
+    inline std::vector<chunk> split(
+      const std::u32string_view& source,
+      const structural_index& index,
+      std::size_t max_chunks
+    )
+    {
+      const auto& spans = index.root_spans();
+      const auto target = source.length() / max_chunks;
+      std::vector<chunk> chunks;
+      std::size_t begin = 0;
+
+      for (std::size_t i = 0; i + 1 < spans.size(); ++i)
+      {
+        if (spans[i].end - begin >= target)
+        {
+          const auto gap = source.substr(
+            spans[i].end,
+            spans[i + 1].begin - spans[i].end
+          );
+
+          if (!blank(gap))
+          {
+            return {};
+          }
+          chunks.push_back({ begin, spans[i].end, {} });
+          begin = spans[i + 1].begin;
+        }
+      }
+      chunks.push_back({ begin, source.length(), {} });
+
+      return chunks;
+    }
+  }
+
+  /**
+   * Parses an entire Plorth program using multiple threads. The source code
+   * is first scanned to find top level values, which are then divided into
+   * chunks that are parsed in parallel by the thread pool. Result, including
+   * positions of the tokens and any errors, is identical to the one returned
+   * by parse().
+   *
+   * The builder is used from multiple threads at the same time, so it must
+   * be safe to do so. The default AST builder is, unless it uses a symbol
+   * table or an allocator which is not thread safe.
+   *
+   * \param current        Iterator pointing to current position in source
+   *                       code, which must be stored in contiguous memory.
+   * \param end            Iterator pointing to end of the source code.
+   * \param position       Current source code position.
+   * \param pool           Thread pool used to parse the chunks. This
+   *                       function must not be called from a task running
+   *                       in the same pool.
+   * \param builder        Builder used to construct the AST tokens.
+   * \param min_chunk_size Smallest number of characters worth parsing in
+   *                       a separate task.
+   */
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_result<BuilderT> parse_parallel(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position,
+    thread_pool& pool,
+    const BuilderT& builder = BuilderT(),
+    std::size_t min_chunk_size = 64 * 1024
+  )
+  {
+    static_assert(utils::is_contiguous_v<IteratorT>);
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    using result_type = basic_parse_result<BuilderT>;
+    const auto source = utils::slice(current, end);
+    const auto max_chunks = std::min(
+      pool.size() * 4,
+      source.length() / std::max<std::size_t>(min_chunk_size, 1)
+    );
+
+    if (pool.size() < 2 || max_chunks < 2)
+    {
+      return parse(current, end, position, builder);
+    }
+
+    const structural_index index(source);
+
+    // Source code which is not well formed is left to the sequential parser,
+    // so that the error is reported exactly like it would be otherwise.
+    if (!index.balanced() || index.roots() < 2)
+    {
+      return parse(current, end, position, builder);
+    }
+
+    auto chunks = internal::split(source, index, max_chunks);
+
+    if (chunks.size() < 2)
+    {
+      return parse(current, end, position, builder);
+    }
+
+    std::vector<std::future<struct position>> positions;
+    std::vector<std::future<std::pair<result_type, struct position>>> results;
+
+    // Positions at the beginning of each chunk are found by counting line
+    // feeds in the preceding chunks in parallel.
+    positions.reserve(chunks.size());
+    for (std::size_t i = 1; i < chunks.size(); ++i)
+    {
+      positions.push_back(pool.submit([&, i]()
+      {
+        const auto begin = chunks[i - 1].begin;
+
+        return internal::advance_position(
+          { interned_string(), 0, 0, 0 },
+          source.substr(begin, chunks[i].begin - begin)
+        );
+      }));
+    }
+    chunks[0].position = position;
+    for (std::size_t i = 1; i < chunks.size(); ++i)
+    {
+      const auto delta = positions[i - 1].get();
+      auto& p = chunks[i].position;
+
+      p = chunks[i - 1].position;
+      p.offset += delta.offset;
+      if (delta.line > 0)
+      {
+        p.line += delta.line;
+        p.column = delta.column;
+      } else {
+        p.column += delta.column;
+      }
+    }
+
+    results.reserve(chunks.size());
+    for (const auto& chunk : chunks)
+    {
+      results.push_back(pool.submit([&current, &builder, &chunk]()
+      {
+        auto chunk_current = current + chunk.begin;
+        const auto chunk_end = current + chunk.end;
+        auto chunk_position = chunk.position;
+        auto result = parse(
+          chunk_current,
+          chunk_end,
+          chunk_position,
+          builder
+        );
+
+        return std::make_pair(std::move(result), chunk_position);
+      }));
+    }
+
+    std::vector<typename BuilderT::token_type> tokens;
+    struct position end_position;
+    bool failed = false;
+
+    // Tasks refer to local variables, so they must all finish before any
+    // exception thrown by one of them is passed on.
+    for (auto& future : results)
+    {
+      future.wait();
+    }
+
+    tokens.reserve(index.roots());
+    for (auto& future : results)
+    {
+      auto [result, chunk_position] = future.get();
+
+      if (!result)
+      {
+        failed = true;
+        continue;
+      }
+      for (auto& token : *result)
+      {
+        tokens.push_back(std::move(token));
+      }
+      end_position = chunk_position;
+    }
+
+    if (failed)
+    {
+      return parse(current, end, position, builder);
+    }
+
+    current = end;
+    position = end_position;
+
+    return result_type::ok(std::move(tokens));
+  }
+}
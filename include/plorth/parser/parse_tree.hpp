@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <memory>
+
+#include <plorth/parser/flat.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Handle to single parsed Plorth program, where all of the nodes of the
+   * program reside in the few contiguous tables of a flat::tree shared by
+   * copies of the handle. Nodes are plain indices into those tables, so
+   * constructing the tree does not allocate per token and destroying it
+   * releases the tables at once, without touching reference counts or
+   * running destructors of individual nodes.
+   *
+   * Programs which need the tokens as shared pointers to AST nodes can
+   * convert the tree with to_ast(). The resulting tokens own their memory
+   * and remain valid after the parse tree has been destroyed.
+   */
+  class parse_tree
+  {
+  public:
+    using const_iterator = flat::index_range::const_iterator;
+    using result_type = peelo::result<parse_tree, error>;
+
+    /**
+     * Attempts to parse an entire Plorth program into a parse tree.
+     *
+     * \param current  Iterator pointing to current position in source code.
+     * \param end      Iterator pointing to end of the source code.
+     * \param position Current source code position.
+     */
+    template<class IteratorT>
+    static result_type parse(
+      IteratorT& current,
+      const IteratorT& end,
+      struct position& position
+    )
+    {
+      auto result = flat::parse(current, end, position);
+
+      if (!result)
+      {
+        return result_type::error(result.error());
+      }
+
+      return result_type::ok(parse_tree(
+        std::make_shared<const flat::tree>(std::move(*result))
+      ));
+    }
+
+    /**
+     * Returns the flat tree which contains the nodes of the program.
+     */
+    inline const flat::tree& tree() const
+    {
+      return *m_tree;
+    }
+
+    /**
+     * Returns the top level nodes of the program.
+     */
+    inline flat::index_range roots() const
+    {
+      return m_tree->roots();
+    }
+
+    inline const_iterator begin() const
+    {
+      return roots().begin();
+    }
+
+    inline const_iterator end() const
+    {
+      return roots().end();
+    }
+
+    inline std::size_t size() const
+    {
+      return roots().size();
+    }
+
+    /**
+     * Converts the parse tree into AST tokens, using given builder to
+     * construct the tokens.
+     *
+     * \param lines   Line index of the source code the tree was parsed from,
+     *                used to resolve positions of the tokens.
+     * \param builder Builder used to construct the tokens.
+     */
+    template<class CharT, class BuilderT = ast::builder<>>
+    std::vector<typename BuilderT::token_type> to_ast(
+      const basic_line_index<CharT>& lines,
+      const BuilderT& builder = BuilderT()
+    ) const
+    {
+      return flat::to_ast(*m_tree, lines, builder);
+    }
+
+  private:
+    explicit parse_tree(const std::shared_ptr<const flat::tree>& tree)
+      : m_tree(tree) {}
+
+    std::shared_ptr<const flat::tree> m_tree;
+  };
+}
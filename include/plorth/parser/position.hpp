@@ -25,17 +25,59 @@
  */
 #pragma once
 
-#include <string>
+#include <cstdint>
+
+#include <plorth/parser/interned_string.hpp>
 
 namespace plorth::parser
 {
   /**
    * Represents position in source code.
+   *
+   * When `PLORTH_PARSER_OFFSETS_ONLY` is defined, the parser only keeps
+   * track of the offset, which saves a branch per character, and leaves
+   * the line and column as they were given to it. Line and column of any
+   * offset can then be resolved with a line index when needed.
    */
   struct position
   {
-    std::u32string file;
-    int line;
-    int column;
+    /**
+     * Name of the file. Copies of the position share the same file name
+     * instead of copying it, so copying a position does not allocate.
+     */
+    interned_string file;
+    std::int64_t line = 1;
+    std::int64_t column = 1;
+    /**
+     * Offset from beginning of the source code, measured in code units of
+     * the input (bytes for UTF-8 input, code points for UTF-32 input).
+     */
+    std::uint64_t offset = 0;
+  };
+
+  /**
+   * Represents range of source code as offsets from beginning of the source
+   * code. The range includes the beginning but excludes the end.
+   */
+  struct source_span
+  {
+    std::uint64_t begin;
+    std::uint64_t end;
+
+    /**
+     * Returns length of the range in code units.
+     */
+    inline std::uint64_t length() const
+    {
+      return end - begin;
+    }
+
+    /**
+     * Returns true if given offset is within the range.
+     */
+    inline bool contains(std::uint64_t offset) const
+    {
+      return offset >= begin && offset < end;
+    }
   };
 }
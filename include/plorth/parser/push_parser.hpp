@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <plorth/parser.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Parser which receives UTF-8 encoded source code in chunks of arbitrary
+   * size, such as when reading from a socket or a pipe, and returns each top
+   * level token as soon as it has been received completely.
+   *
+   * Received bytes are scanned for the end of the current top level token,
+   * while keeping track of string literals, escape sequences, comments and
+   * nested arrays, objects and quotes across chunk boundaries. Complete
+   * tokens are then parsed with the regular parser and discarded from the
+   * buffer, so only the token currently being received is held in memory.
+   *
+   * Tokens returned by the parser, concatenated together, are identical to
+   * the ones which parse() would return for the entire source code.
+   */
+  template<class BuilderT = ast::builder<>>
+  class basic_push_parser
+  {
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+
+  public:
+    using builder_type = BuilderT;
+    using result_type = basic_parse_result<BuilderT>;
+
+    /**
+     * Constructs push parser.
+     *
+     * \param position Position of the beginning of the source code.
+     * \param builder  Builder used to construct the AST tokens.
+     */
+    explicit basic_push_parser(
+      const struct position& position = {},
+      const builder_type& builder = builder_type()
+    )
+      : m_position(position)
+      , m_builder(builder)
+      , m_scanned(0)
+      , m_complete(0)
+      , m_state(state::token)
+      , m_separator(0)
+      , m_escape(false)
+      , m_word_begin(0)
+      , m_definition(false)
+      , m_failed(false) {}
+
+    /**
+     * Returns position in the source code where the next token to be
+     * returned begins, or where parsing failed.
+     */
+    inline const struct position& position() const
+    {
+      return m_position;
+    }
+
+    /**
+     * Returns the number of bytes received but not yet parsed.
+     */
+    inline std::size_t buffered() const
+    {
+      return m_buffer.length();
+    }
+
+    /**
+     * Receives next chunk of the source code and returns the top level
+     * tokens completed by it, which might be none. Once an error has been
+     * returned, it will be returned again by every subsequent call.
+     */
+    result_type feed(const std::string_view& chunk)
+    {
+      if (m_failed)
+      {
+        return result_type::error(*m_error);
+      }
+      m_buffer.append(chunk);
+      scan();
+
+      return flush(m_complete);
+    }
+
+    /**
+     * Signals end of the source code and returns the remaining top level
+     * tokens. The parser can be used to parse another program after this.
+     */
+    result_type finish()
+    {
+      if (m_failed)
+      {
+        return result_type::error(*m_error);
+      }
+
+      auto result = flush(m_buffer.length());
+
+      m_state = state::token;
+      m_stack.clear();
+      m_escape = false;
+      m_definition = false;
+
+      return result;
+    }
+
+  private:
+    enum class state
+    {
+      token,
+      word,
+      string,
+      comment
+    };
+
+    enum class expect
+    {
+      value,
+      key,
+      colon,
+      separator
+    };
+
+    struct frame
+    {
+      char bracket;
+      expect state;
+    };
+
+    /**
+     * Parses the first given number of bytes from the buffer, and removes
+     * them from it.
+     */
+    result_type flush(std::size_t length)
+    {
+      if (!length)
+      {
+        return result_type::ok(std::vector<typename BuilderT::token_type>());
+      }
+
+      auto result = parse(
+        std::string_view(m_buffer.data(), length),
+        m_position,
+        m_builder
+      );
+
+      if (!result)
+      {
+        m_failed = true;
+        m_error = result.error();
+        m_position = result.error().position;
+
+        return result;
+      }
+      m_buffer.erase(0, length);
+      m_scanned -= length;
+      m_word_begin -= std::min(m_word_begin, length);
+      m_complete = 0;
+
+      return result;
+    }
+
+    /**
+     * Called when a value has been completely received.
+     */
+    void complete_value(std::size_t end)
+    {
+      if (m_stack.empty())
+      {
+        m_complete = end;
+        m_definition = false;
+      }
+      else if (m_stack.back().bracket == '{')
+      {
+        m_stack.back().state = m_stack.back().state == expect::key
+          ? expect::colon
+          : expect::separator;
+      }
+    }
+
+    /**
+     * Called when a word has been completely received. Word definition is
+     * not complete until the symbol following `->' has been received.
+     */
+    void complete_word(std::size_t end)
+    {
+      m_definition = !m_definition
+        && end - m_word_begin == 2
+        && m_buffer.compare(m_word_begin, 2, "->") == 0;
+      if (m_definition && m_stack.empty())
+      {
+        return;
+      }
+      complete_value(end);
+    }
+
+    void scan()
+    {
+      const auto length = m_buffer.length();
+
+      while (m_scanned < length)
+      {
+        const auto byte = static_cast<unsigned char>(m_buffer[m_scanned]);
+
+        if (m_state == state::comment)
+        {
+          if (byte == '\n' || byte == '\r')
+          {
+            m_state = state::token;
+          }
+          ++m_scanned;
+          continue;
+        }
+        else if (m_state == state::string)
+        {
+          if (m_escape)
+          {
+            m_escape = false;
+          }
+          else if (byte == '\\')
+          {
+            m_escape = true;
+          }
+          else if (byte == m_separator)
+          {
+            m_state = state::token;
+            complete_value(m_scanned + 1);
+          }
+          ++m_scanned;
+          continue;
+        }
+
+        char32_t c = byte;
+        std::size_t sequence_length = 1;
+
+        if (byte >= 0x80)
+        {
+          // Wait for rest of the sequence, if it has been split between
+          // chunks.
+          if (length - m_scanned < utf8::sequence_length(byte))
+          {
+            break;
+          }
+          c = utf8::decode(
+            std::cbegin(m_buffer) + m_scanned,
+            std::cend(m_buffer),
+            sequence_length
+          );
+        }
+
+        if (m_state == state::word)
+        {
+          if (utils::isword(c))
+          {
+            m_scanned += sequence_length;
+            continue;
+          }
+          m_state = state::token;
+          complete_word(m_scanned);
+        }
+
+        scan_token(c, sequence_length);
+      }
+    }
+
+    /**
+     * Scans character which begins a token, or is found between them.
+     */
+    void scan_token(char32_t c, std::size_t sequence_length)
+    {
+      const auto begin = m_scanned;
+      const bool in_object = !m_stack.empty()
+        && m_stack.back().bracket == '{';
+
+      m_scanned += sequence_length;
+      if (utils::isspace(c))
+      {
+        return;
+      }
+
+      switch (c)
+      {
+        case '#':
+          m_state = state::comment;
+          return;
+
+        case '"':
+        case '\'':
+          // Symbol following `->' may begin with a quote character, which
+          // is then scanned as part of the symbol.
+          if (m_definition)
+          {
+            break;
+          }
+          m_state = state::string;
+          m_separator = static_cast<char>(c);
+          return;
+
+        case '[':
+        case '{':
+        case '(':
+          m_definition = false;
+          if (in_object)
+          {
+            m_stack.back().state = expect::separator;
+          }
+          m_stack.push_back({
+            static_cast<char>(c),
+            c == '{' ? expect::key : expect::value
+          });
+          return;
+
+        case ']':
+        case '}':
+        case ')':
+          m_definition = false;
+          if (!m_stack.empty())
+          {
+            m_stack.pop_back();
+          }
+          complete_value(m_scanned);
+          return;
+
+        case ',':
+          m_definition = false;
+          if (in_object)
+          {
+            m_stack.back().state = expect::key;
+          }
+          else if (m_stack.empty())
+          {
+            complete_value(m_scanned);
+          }
+          return;
+
+        case ':':
+          if (in_object && m_stack.back().state == expect::colon)
+          {
+            m_stack.back().state = expect::value;
+            return;
+          }
+          break;
+      }
+
+      if (utils::isword(c))
+      {
+        m_state = state::word;
+        m_word_begin = begin;
+      } else {
+        // Parser will reject this character.
+        complete_value(m_scanned);
+      }
+    }
+
+    struct position m_position;
+    const builder_type m_builder;
+    std::string m_buffer;
+    std::size_t m_scanned;
+    std::size_t m_complete;
+    state m_state;
+    char m_separator;
+    bool m_escape;
+    std::size_t m_word_begin;
+    bool m_definition;
+    std::vector<frame> m_stack;
+    bool m_failed;
+    std::optional<error> m_error;
+  };
+
+  using push_parser = basic_push_parser<>;
+}
@@ -0,0 +1,742 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+
+#if !defined(PLORTH_PARSER_NO_SIMD)
+# if defined(__AVX2__)
+#  define PLORTH_PARSER_SCAN_AVX2 1
+#  include <immintrin.h>
+# elif defined(__SSE2__) || defined(_M_X64) \
+  || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define PLORTH_PARSER_SCAN_SSE2 1
+#  include <emmintrin.h>
+# endif
+#endif
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+/**
+ * Kernels used by the parser to skip over runs of characters in source code
+ * stored in contiguous memory. None of the runs contain line breaks, so the
+ * caller can update the source code position in bulk.
+ *
+ * The kernels use AVX2 or SSE2 instructions when the compiler targets them,
+ * and fall back to scalar implementations otherwise. Vectorization can be
+ * disabled by defining `PLORTH_PARSER_NO_SIMD`.
+ */
+namespace plorth::parser::scan
+{
+  /**
+   * Name of the instruction set used by the kernels.
+   */
+#if defined(PLORTH_PARSER_SCAN_AVX2)
+  inline constexpr const char* instruction_set = "avx2";
+#elif defined(PLORTH_PARSER_SCAN_SSE2)
+  inline constexpr const char* instruction_set = "sse2";
+#else
+  inline constexpr const char* instruction_set = "scalar";
+#endif
+
+  /**
+   * Scalar implementations of the kernels, used for the remainder which
+   * does not fill an entire vector register and when vectorization is not
+   * available.
+   */
+  namespace scalar
+  {
+    /**
+     * Returns pointer to the first separator, backslash or line feed in the
+     * given range, or end of the range if there are none.
+     */
+    inline const char32_t* find_string_delimiter(
+      const char32_t* first,
+      const char32_t* last,
+      char32_t separator
+    )
+    {
+      for (; first < last; ++first)
+      {
+        const auto c = *first;
+
+        if (c == separator || c == '\\' || c == '\n')
+        {
+          break;
+        }
+      }
+
+      return first;
+    }
+
+    /**
+     * Returns pointer to the first line feed or carriage return in the given
+     * range, or end of the range if there are none.
+     */
+    inline const char32_t* find_line_end(
+      const char32_t* first,
+      const char32_t* last
+    )
+    {
+      for (; first < last; ++first)
+      {
+        if (*first == '\n' || *first == '\r')
+        {
+          break;
+        }
+      }
+
+      return first;
+    }
+
+    /**
+     * Returns pointer to the first character in the given range which is not
+     * whitespace other than line feed.
+     */
+    inline const char32_t* skip_blanks(
+      const char32_t* first,
+      const char32_t* last
+    )
+    {
+      for (; first < last; ++first)
+      {
+        const auto c = *first;
+
+        if (c != ' ' && (c < '\t' || c > '\r' || c == '\n'))
+        {
+          break;
+        }
+      }
+
+      return first;
+    }
+
+    /**
+     * Returns pointer to the first character in the given range which is not
+     * an ASCII word character.
+     */
+    inline const char32_t* skip_word(
+      const char32_t* first,
+      const char32_t* last
+    )
+    {
+      for (; first < last; ++first)
+      {
+        const auto c = *first;
+
+        if (c <= ' ' || c >= 0x7f || c == '(' || c == ')' || c == '['
+            || c == ']' || c == '{' || c == '}' || c == ',')
+        {
+          break;
+        }
+      }
+
+      return first;
+    }
+  }
+
+  namespace internal
+  {
+    inline unsigned count_trailing_zeros(unsigned mask)
+    {
+#if defined(_MSC_VER)
+      unsigned long index;
+
+      _BitScanForward(&index, mask);
+
+      return index;
+#else
+      return __builtin_ctz(mask);
+#endif
+    }
+
+#if defined(PLORTH_PARSER_SCAN_AVX2)
+    using vector_type = __m256i;
+
+    static constexpr std::ptrdiff_t vector_length = 8;
+    static constexpr unsigned full_mask = 0xff;
+
+    inline vector_type load(const char32_t* p)
+    {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    inline vector_type broadcast(char32_t c)
+    {
+      return _mm256_set1_epi32(static_cast<int>(c));
+    }
+
+    inline vector_type eq(const vector_type& a, const vector_type& b)
+    {
+      return _mm256_cmpeq_epi32(a, b);
+    }
+
+    inline vector_type gt(const vector_type& a, const vector_type& b)
+    {
+      return _mm256_cmpgt_epi32(a, b);
+    }
+
+    inline vector_type bit_or(const vector_type& a, const vector_type& b)
+    {
+      return _mm256_or_si256(a, b);
+    }
+
+    inline vector_type bit_andnot(const vector_type& a, const vector_type& b)
+    {
+      return _mm256_andnot_si256(a, b);
+    }
+
+    inline unsigned mask(const vector_type& v)
+    {
+      return static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(v))
+      );
+    }
+#elif defined(PLORTH_PARSER_SCAN_SSE2)
+    using vector_type = __m128i;
+
+    static constexpr std::ptrdiff_t vector_length = 4;
+    static constexpr unsigned full_mask = 0xf;
+
+    inline vector_type load(const char32_t* p)
+    {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    inline vector_type broadcast(char32_t c)
+    {
+      return _mm_set1_epi32(static_cast<int>(c));
+    }
+
+    inline vector_type eq(const vector_type& a, const vector_type& b)
+    {
+      return _mm_cmpeq_epi32(a, b);
+    }
+
+    inline vector_type gt(const vector_type& a, const vector_type& b)
+    {
+      return _mm_cmpgt_epi32(a, b);
+    }
+
+    inline vector_type bit_or(const vector_type& a, const vector_type& b)
+    {
+      return _mm_or_si128(a, b);
+    }
+
+    inline vector_type bit_andnot(const vector_type& a, const vector_type& b)
+    {
+      return _mm_andnot_si128(a, b);
+    }
+
+    inline unsigned mask(const vector_type& v)
+    {
+      return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(v)));
+    }
+#endif
+
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+    /**
+     * Runs given predicate over the range one vector at a time, until it
+     * returns a non-zero mask of lanes where the run ends. Returns pointer to
+     * the first character not covered by full vectors when no match is
+     * found.
+     */
+    template<class PredicateT>
+    inline const char32_t* find(
+      const char32_t*& first,
+      const char32_t* last,
+      PredicateT predicate
+    )
+    {
+      for (; last - first >= vector_length; first += vector_length)
+      {
+        if (const auto m = predicate(load(first)))
+        {
+          return first + count_trailing_zeros(m);
+        }
+      }
+
+      return nullptr;
+    }
+#endif
+  }
+
+  /**
+   * Returns pointer to the first separator, backslash or line feed in the
+   * given range, or end of the range if there are none.
+   */
+  inline const char32_t* find_string_delimiter(
+    const char32_t* first,
+    const char32_t* last,
+    char32_t separator
+  )
+  {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+    using namespace internal;
+    const auto s = broadcast(separator);
+    const auto backslash = broadcast('\\');
+    const auto line_feed = broadcast('\n');
+
+    if (const auto result = find(first, last, [&](const vector_type& v)
+    {
+      return mask(
+        bit_or(bit_or(eq(v, s), eq(v, backslash)), eq(v, line_feed))
+      );
+    }))
+    {
+      return result;
+    }
+#endif
+
+    return scalar::find_string_delimiter(first, last, separator);
+  }
+
+  /**
+   * Returns pointer to the first line feed or carriage return in the given
+   * range, or end of the range if there are none.
+   */
+  inline const char32_t* find_line_end(
+    const char32_t* first,
+    const char32_t* last
+  )
+  {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+    using namespace internal;
+    const auto line_feed = broadcast('\n');
+    const auto carriage_return = broadcast('\r');
+
+    if (const auto result = find(first, last, [&](const vector_type& v)
+    {
+      return mask(bit_or(eq(v, line_feed), eq(v, carriage_return)));
+    }))
+    {
+      return result;
+    }
+#endif
+
+    return scalar::find_line_end(first, last);
+  }
+
+  /**
+   * Returns pointer to the first character in the given range which is not
+   * whitespace other than line feed.
+   */
+  inline const char32_t* skip_blanks(
+    const char32_t* first,
+    const char32_t* last
+  )
+  {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+    using namespace internal;
+    const auto space = broadcast(' ');
+    const auto line_feed = broadcast('\n');
+    const auto below_tab = broadcast('\t' - 1);
+    const auto above_carriage_return = broadcast('\r' + 1);
+
+    if (const auto result = find(first, last, [&](const vector_type& v)
+    {
+      const auto control = bit_andnot(
+        bit_or(gt(v, above_carriage_return), eq(v, line_feed)),
+        gt(v, below_tab)
+      );
+
+      return mask(bit_or(eq(v, space), control)) ^ full_mask;
+    }))
+    {
+      return result;
+    }
+#endif
+
+    return scalar::skip_blanks(first, last);
+  }
+
+  /**
+   * Returns pointer to the first character in the given range which is not
+   * an ASCII word character. Word characters outside ASCII are left for the
+   * caller to classify.
+   */
+  inline const char32_t* skip_word(
+    const char32_t* first,
+    const char32_t* last
+  )
+  {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+    using namespace internal;
+    const auto space = broadcast(' ');
+    const auto del = broadcast(0x7f);
+    const auto lparen = broadcast('(');
+    const auto rparen = broadcast(')');
+    const auto lbrack = broadcast('[');
+    const auto rbrack = broadcast(']');
+    const auto lbrace = broadcast('{');
+    const auto rbrace = broadcast('}');
+    const auto comma = broadcast(',');
+
+    if (const auto result = find(first, last, [&](const vector_type& v)
+    {
+      const auto brackets = bit_or(
+        bit_or(eq(v, lparen), eq(v, rparen)),
+        bit_or(eq(v, lbrack), eq(v, rbrack))
+      );
+      const auto delimiter = bit_or(
+        brackets,
+        bit_or(bit_or(eq(v, lbrace), eq(v, rbrace)), eq(v, comma))
+      );
+      const auto graph = bit_andnot(gt(v, del), gt(v, space));
+      const auto del_or_delimiter = bit_or(eq(v, del), delimiter);
+
+      return mask(bit_andnot(del_or_delimiter, graph)) ^ full_mask;
+    }))
+    {
+      return result;
+    }
+#endif
+
+    return scalar::skip_word(first, last);
+  }
+
+  namespace internal::bytes
+  {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+    using internal::bit_andnot;
+    using internal::bit_or;
+    using internal::vector_type;
+#endif
+
+#if defined(PLORTH_PARSER_SCAN_AVX2)
+    static constexpr std::ptrdiff_t vector_length = 32;
+    static constexpr unsigned full_mask = 0xffffffff;
+
+    inline vector_type load(const char* p)
+    {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    inline vector_type broadcast(char c)
+    {
+      return _mm256_set1_epi8(c);
+    }
+
+    inline vector_type eq(const vector_type& a, const vector_type& b)
+    {
+      return _mm256_cmpeq_epi8(a, b);
+    }
+
+    inline vector_type gt(const vector_type& a, const vector_type& b)
+    {
+      return _mm256_cmpgt_epi8(a, b);
+    }
+
+    inline unsigned mask(const vector_type& v)
+    {
+      return static_cast<unsigned>(_mm256_movemask_epi8(v));
+    }
+#elif defined(PLORTH_PARSER_SCAN_SSE2)
+    static constexpr std::ptrdiff_t vector_length = 16;
+    static constexpr unsigned full_mask = 0xffff;
+
+    inline vector_type load(const char* p)
+    {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    inline vector_type broadcast(char c)
+    {
+      return _mm_set1_epi8(c);
+    }
+
+    inline vector_type eq(const vector_type& a, const vector_type& b)
+    {
+      return _mm_cmpeq_epi8(a, b);
+    }
+
+    inline vector_type gt(const vector_type& a, const vector_type& b)
+    {
+      return _mm_cmpgt_epi8(a, b);
+    }
+
+    inline unsigned mask(const vector_type& v)
+    {
+      return static_cast<unsigned>(_mm_movemask_epi8(v));
+    }
+#endif
+
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+    /**
+     * Byte variant of internal::find(). Comparisons of bytes are signed, so
+     * bytes which are not ASCII compare less than any ASCII character, and
+     * the sign bit of each byte, which mask() of the byte itself returns,
+     * tells whether it's ASCII.
+     */
+    template<class PredicateT>
+    inline const char* find(
+      const char*& first,
+      const char* last,
+      PredicateT predicate
+    )
+    {
+      for (; last - first >= vector_length; first += vector_length)
+      {
+        if (const auto m = predicate(load(first)))
+        {
+          return first + count_trailing_zeros(m);
+        }
+      }
+
+      return nullptr;
+    }
+#endif
+  }
+
+  /**
+   * Kernels for UTF-8 encoded source code. Each of them also stops at the
+   * first byte which is not ASCII, so that every byte of a run is a
+   * character of it's own and the caller can update the column in bulk.
+   */
+  namespace ascii
+  {
+    /**
+     * Scalar implementations of the kernels for UTF-8 encoded source code.
+     */
+    namespace scalar
+    {
+      /**
+       * Returns pointer to the first separator, backslash, line feed or non
+       * ASCII byte in the given range, or end of the range if there are none.
+       */
+      inline const char* find_string_delimiter(
+        const char* first,
+        const char* last,
+        char32_t separator
+      )
+      {
+        for (; first < last; ++first)
+        {
+          const auto c = static_cast<unsigned char>(*first);
+
+          if (c == separator || c == '\\' || c == '\n' || c >= 0x80)
+          {
+            break;
+          }
+        }
+
+        return first;
+      }
+
+      /**
+       * Returns pointer to the first line feed, carriage return or non ASCII
+       * byte in the given range, or end of the range if there are none.
+       */
+      inline const char* find_line_end(const char* first, const char* last)
+      {
+        for (; first < last; ++first)
+        {
+          const auto c = static_cast<unsigned char>(*first);
+
+          if (c == '\n' || c == '\r' || c >= 0x80)
+          {
+            break;
+          }
+        }
+
+        return first;
+      }
+
+      /**
+       * Returns pointer to the first byte in the given range which is not
+       * whitespace other than line feed.
+       */
+      inline const char* skip_blanks(const char* first, const char* last)
+      {
+        for (; first < last; ++first)
+        {
+          const auto c = *first;
+
+          if (c != ' ' && (c < '\t' || c > '\r' || c == '\n'))
+          {
+            break;
+          }
+        }
+
+        return first;
+      }
+
+      /**
+       * Returns pointer to the first byte in the given range which is not an
+       * ASCII word character.
+       */
+      inline const char* skip_word(const char* first, const char* last)
+      {
+        for (; first < last; ++first)
+        {
+          const auto c = static_cast<unsigned char>(*first);
+
+          if (c <= ' ' || c >= 0x7f || c == '(' || c == ')' || c == '['
+              || c == ']' || c == '{' || c == '}' || c == ',')
+          {
+            break;
+          }
+        }
+
+        return first;
+      }
+    }
+
+    /**
+     * Returns pointer to the first separator, backslash, line feed or non
+     * ASCII byte in the given range, or end of the range if there are none.
+     */
+    inline const char* find_string_delimiter(
+      const char* first,
+      const char* last,
+      char32_t separator
+    )
+    {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+      using namespace internal::bytes;
+
+      if (separator < 0x80)
+      {
+        const auto s = broadcast(static_cast<char>(separator));
+        const auto backslash = broadcast('\\');
+        const auto line_feed = broadcast('\n');
+
+        if (const auto result = find(first, last, [&](const vector_type& v)
+        {
+          return mask(bit_or(
+            bit_or(bit_or(eq(v, s), eq(v, backslash)), eq(v, line_feed)),
+            v
+          ));
+        }))
+        {
+          return result;
+        }
+      }
+#endif
+
+      return scalar::find_string_delimiter(first, last, separator);
+    }
+
+    /**
+     * Returns pointer to the first line feed, carriage return or non ASCII
+     * byte in the given range, or end of the range if there are none.
+     */
+    inline const char* find_line_end(const char* first, const char* last)
+    {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+      using namespace internal::bytes;
+      const auto line_feed = broadcast('\n');
+      const auto carriage_return = broadcast('\r');
+
+      if (const auto result = find(first, last, [&](const vector_type& v)
+      {
+        return mask(
+          bit_or(bit_or(eq(v, line_feed), eq(v, carriage_return)), v)
+        );
+      }))
+      {
+        return result;
+      }
+#endif
+
+      return scalar::find_line_end(first, last);
+    }
+
+    /**
+     * Returns pointer to the first byte in the given range which is not
+     * whitespace other than line feed.
+     */
+    inline const char* skip_blanks(const char* first, const char* last)
+    {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+      using namespace internal::bytes;
+      const auto space = broadcast(' ');
+      const auto line_feed = broadcast('\n');
+      const auto below_tab = broadcast('\t' - 1);
+      const auto above_carriage_return = broadcast('\r' + 1);
+
+      if (const auto result = find(first, last, [&](const vector_type& v)
+      {
+        const auto control = bit_andnot(
+          bit_or(gt(v, above_carriage_return), eq(v, line_feed)),
+          gt(v, below_tab)
+        );
+
+        return mask(bit_or(eq(v, space), control)) ^ full_mask;
+      }))
+      {
+        return result;
+      }
+#endif
+
+      return scalar::skip_blanks(first, last);
+    }
+
+    /**
+     * Returns pointer to the first byte in the given range which is not an
+     * ASCII word character.
+     */
+    inline const char* skip_word(const char* first, const char* last)
+    {
+#if defined(PLORTH_PARSER_SCAN_AVX2) || defined(PLORTH_PARSER_SCAN_SSE2)
+      using namespace internal::bytes;
+      const auto space = broadcast(' ');
+      const auto del = broadcast(0x7f);
+      const auto lparen = broadcast('(');
+      const auto rparen = broadcast(')');
+      const auto lbrack = broadcast('[');
+      const auto rbrack = broadcast(']');
+      const auto lbrace = broadcast('{');
+      const auto rbrace = broadcast('}');
+      const auto comma = broadcast(',');
+
+      if (const auto result = find(first, last, [&](const vector_type& v)
+      {
+        const auto brackets = bit_or(
+          bit_or(eq(v, lparen), eq(v, rparen)),
+          bit_or(eq(v, lbrack), eq(v, rbrack))
+        );
+        const auto delimiter = bit_or(
+          brackets,
+          bit_or(bit_or(eq(v, lbrace), eq(v, rbrace)), eq(v, comma))
+        );
+        // Bytes which are not ASCII are negative, so they are not greater
+        // than space either.
+        const auto graph = gt(v, space);
+        const auto del_or_delimiter = bit_or(eq(v, del), delimiter);
+
+        return mask(bit_andnot(del_or_delimiter, graph)) ^ full_mask;
+      }))
+      {
+        return result;
+      }
+#endif
+
+      return scalar::skip_word(first, last);
+    }
+  }
+}
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <limits>
+
+#include <plorth/parser.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Index of structural characters in source code, constructed by scanning
+   * the source code once without building any tokens. Brackets, commas,
+   * quotes and colons separating object keys from values are recorded, while
+   * characters inside string literals, comments and symbols are not.
+   *
+   * The index also tells the number of values contained in each array,
+   * object and quote, and which brackets match with each other. The index
+   * does not validate the source code; parser must still be used for that.
+   */
+  class structural_index
+  {
+  public:
+    using size_type = std::uint32_t;
+
+    /** Value used when an entry has no matching entry. */
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    /**
+     * Single structural character in the source code.
+     */
+    struct entry
+    {
+      /** Offset of the character in the source code. */
+      std::uint64_t offset;
+      /** The structural character. */
+      char32_t character;
+      /**
+       * Index of the matching bracket or quote, or npos if there is none.
+       */
+      size_type partner;
+      /**
+       * Number of values in an array or quote, or number of properties in an
+       * object, if the entry begins one.
+       */
+      size_type children;
+    };
+
+    using container_type = std::vector<entry>;
+    using const_iterator = container_type::const_iterator;
+
+    /**
+     * Constructs index of given source code.
+     *
+     * \param source Source code to scan.
+     * \param offset Offset of the source code, which is added to offsets of
+     *               the entries.
+     */
+    explicit structural_index(
+      const std::u32string_view& source,
+      std::uint64_t offset = 0
+    )
+      : m_balanced(true)
+    {
+      scan(source, offset);
+    }
+
+    /**
+     * Returns the entries of the index, ordered by their offsets.
+     */
+    inline const container_type& entries() const
+    {
+      return m_entries;
+    }
+
+    inline const_iterator begin() const
+    {
+      return std::cbegin(m_entries);
+    }
+
+    inline const_iterator end() const
+    {
+      return std::cend(m_entries);
+    }
+
+    inline std::size_t size() const
+    {
+      return m_entries.size();
+    }
+
+    inline const entry& operator[](std::size_t index) const
+    {
+      return m_entries[index];
+    }
+
+    /**
+     * Returns the number of top level values in the source code.
+     */
+    inline size_type roots() const
+    {
+      return static_cast<size_type>(m_root_spans.size());
+    }
+
+    /**
+     * Returns the ranges of source code occupied by top level values, with
+     * a word definition covering both the `->' and the symbol following it.
+     * Top level values can be parsed independently of each other.
+     */
+    inline const std::vector<source_span>& root_spans() const
+    {
+      return m_root_spans;
+    }
+
+    /**
+     * Returns true if every bracket in the source code has a matching one,
+     * every string literal is terminated and the source code contains no
+     * characters which the parser rejects where they appear, such as control
+     * characters or commas outside arrays and objects. If this is false,
+     * parsing the source code fails.
+     */
+    inline bool balanced() const
+    {
+      return m_balanced;
+    }
+
+  private:
+    enum class expect
+    {
+      value,
+      key,
+      colon
+    };
+
+    struct frame
+    {
+      size_type entry;
+      expect state;
+    };
+
+    size_type record(std::uint64_t offset, char32_t character)
+    {
+      m_entries.push_back({ offset, character, npos, 0 });
+
+      return static_cast<size_type>(m_entries.size() - 1);
+    }
+
+    void scan(const std::u32string_view& source, std::uint64_t base)
+    {
+      const auto begin = source.data();
+      const auto end = begin + source.length();
+      std::vector<frame> stack;
+      bool word_definition = false;
+
+      // Counts a new value in the innermost container, or at top level.
+      const auto count = [&](std::uint64_t offset)
+      {
+        if (stack.empty())
+        {
+          m_root_spans.push_back({ offset, offset });
+        } else {
+          ++m_entries[stack.back().entry].children;
+        }
+      };
+
+      // Extends the span of the current top level value up to given offset.
+      const auto extend = [&](std::uint64_t offset)
+      {
+        if (stack.empty() && !m_root_spans.empty())
+        {
+          m_root_spans.back().end = offset;
+        }
+      };
+
+      for (auto current = begin; current < end;)
+      {
+        const auto c = *current;
+        const auto offset = base + (current - begin);
+        const bool in_object = !stack.empty()
+          && m_entries[stack.back().entry].character == '{';
+
+        if (utils::isspace(c))
+        {
+          current = scan::skip_blanks(current + 1, end);
+          continue;
+        }
+
+        switch (c)
+        {
+          case '#':
+            current = scan::find_line_end(current + 1, end);
+            if (current < end)
+            {
+              ++current;
+            }
+            continue;
+
+          case '[':
+          case '{':
+          case '(':
+            if (!in_object)
+            {
+              count(offset);
+            } else {
+              stack.back().state = expect::value;
+            }
+            stack.push_back({
+              record(offset, c),
+              c == '{' ? expect::key : expect::value
+            });
+            word_definition = false;
+            ++current;
+            continue;
+
+          case ']':
+          case '}':
+          case ')':
+          {
+            const auto index = record(offset, c);
+
+            if (stack.empty() || m_entries[stack.back().entry].character != (
+              c == ']' ? '[' : c == '}' ? '{' : '('
+            ))
+            {
+              m_balanced = false;
+            } else {
+              m_entries[stack.back().entry].partner = index;
+              m_entries[index].partner = stack.back().entry;
+              stack.pop_back();
+              extend(offset + 1);
+            }
+            ++current;
+            continue;
+          }
+
+          case ',':
+            record(offset, c);
+            if (in_object)
+            {
+              stack.back().state = expect::key;
+            }
+            else if (stack.empty()
+                || m_entries[stack.back().entry].character != '[')
+            {
+              // Commas are only accepted inside arrays and objects.
+              m_balanced = false;
+            }
+            ++current;
+            continue;
+
+          case ':':
+            if (in_object && stack.back().state == expect::colon)
+            {
+              record(offset, c);
+              stack.back().state = expect::value;
+              ++current;
+              continue;
+            }
+            break;
+
+          case '"':
+          case '\'':
+          {
+            // Symbol following `->' may begin with a quote character.
+            if (word_definition)
+            {
+              break;
+            }
+
+            const auto opening = record(offset, c);
+
+            // Object properties are counted by their keys.
+            if (!in_object || stack.back().state == expect::key)
+            {
+              count(offset);
+            }
+            if (in_object)
+            {
+              stack.back().state = stack.back().state == expect::key
+                ? expect::colon
+                : expect::value;
+            }
+            current = skip_string(current + 1, end, c);
+            if (current < end)
+            {
+              const auto closing = record(base + (current - begin), c);
+
+              m_entries[opening].partner = closing;
+              m_entries[closing].partner = opening;
+              ++current;
+              extend(base + (current - begin));
+            } else {
+              m_balanced = false;
+            }
+            word_definition = false;
+            continue;
+          }
+        }
+
+        if (!utils::isword(c))
+        {
+          // Parser rejects this character, so parsing the source code fails.
+          m_balanced = false;
+          ++current;
+          continue;
+        }
+
+        const auto word_begin = current;
+
+        do
+        {
+          current = scan::skip_word(current + 1, end);
+        }
+        while (current < end && utils::isword(*current));
+
+        // Symbol which follows `->' belongs to the same word definition.
+        if (!word_definition && !in_object)
+        {
+          count(offset);
+        }
+        extend(base + (current - begin));
+        word_definition = !word_definition
+          && current - word_begin == 2
+          && word_begin[0] == '-'
+          && word_begin[1] == '>';
+      }
+
+      if (!stack.empty())
+      {
+        m_balanced = false;
+      }
+    }
+
+    static const char32_t* skip_string(
+      const char32_t* current,
+      const char32_t* end,
+      char32_t separator
+    )
+    {
+      while (current < end)
+      {
+        current = scan::find_string_delimiter(current, end, separator);
+        if (current >= end || *current == separator)
+        {
+          break;
+        }
+        // Skip the escaped character, or the line feed.
+        current += *current == '\\' ? 2 : 1;
+      }
+
+      return current < end ? current : end;
+    }
+
+    container_type m_entries;
+    std::vector<source_span> m_root_spans;
+    bool m_balanced;
+  };
+
+  /**
+   * Builder which wraps another builder and reserves space for values in
+   * arrays, objects and quotes based on a structural index, so that the
+   * containers never need to grow while they are being filled.
+   */
+  template<class BuilderT>
+  class indexed_builder : public BuilderT
+  {
+  public:
+    /**
+     * Constructs indexed builder. The structural index must outlive the
+     * builder.
+     *
+     * \param builder Builder used to construct the tokens.
+     * \param index   Structural index of the source code being parsed.
+     */
+    explicit indexed_builder(
+      const BuilderT& builder,
+      const structural_index& index
+    )
+      : BuilderT(builder)
+      , m_index(&index)
+      , m_cursor(0) {}
+
+    /**
+     * Reserves space in the container of an array, object or quote beginning
+     * at given position in the source code, or in the container of top level
+     * values if no position is given.
+     */
+    template<class ContainerT>
+    void reserve(
+      ContainerT& container,
+      const struct position* position = nullptr
+    ) const
+    {
+      if (!position)
+      {
+        container.reserve(m_index->roots());
+        return;
+      }
+
+      // Containers are opened in the same order as they appear in the
+      // index, so the cursor only ever needs to move forward.
+      while (m_cursor < m_index->size())
+      {
+        const auto& entry = (*m_index)[m_cursor++];
+
+        if (entry.offset >= position->offset
+            && (entry.character == '['
+              || entry.character == '{'
+              || entry.character == '('))
+        {
+          container.reserve(entry.children);
+          break;
+        }
+      }
+    }
+
+  private:
+    const structural_index* m_index;
+    mutable std::size_t m_cursor;
+  };
+
+  /**
+   * Parses an entire Plorth program in two stages: first the source code is
+   * scanned to construct a structural index of it, then the AST tokens are
+   * constructed, with every container sized exactly before it is filled.
+   * Result is identical to the one returned by parse().
+   *
+   * \param current  Iterator pointing to current position in source code,
+   *                 which must be stored in contiguous memory.
+   * \param end      Iterator pointing to end of the source code.
+   * \param position Current source code position.
+   * \param builder  Builder used to construct the AST tokens.
+   */
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  basic_parse_result<BuilderT> parse_indexed(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position,
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    static_assert(utils::is_contiguous_v<IteratorT>);
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+    const structural_index index(utils::slice(current, end), position.offset);
+
+    return parse(
+      current,
+      end,
+      position,
+      indexed_builder<BuilderT>(builder, index)
+    );
+  }
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <plorth/parser/interned_string.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Table which interns symbol identifiers and object keys, so that each
+   * distinct identifier is stored in memory only once no matter how many
+   * times it appears in the source code. Same table can be shared by
+   * multiple parses.
+   *
+   * The table is thread safe only if it's constructed to be, in which case
+   * it can be shared by parses running in different threads at the same
+   * time.
+   */
+  class symbol_table
+  {
+  public:
+    /**
+     * Constructs empty symbol table.
+     *
+     * \param thread_safe Whether the table should be safe to use from
+     *                    multiple threads at the same time.
+     */
+    explicit symbol_table(bool thread_safe = false)
+      : m_mutex(thread_safe ? std::make_unique<std::mutex>() : nullptr)
+      , m_id(next_id()) {}
+
+    /**
+     * Returns true if the table is safe to use from multiple threads at the
+     * same time.
+     */
+    inline bool thread_safe() const
+    {
+      return !!m_mutex;
+    }
+
+    /**
+     * Returns interned copy of given string, adding it to the table if it's
+     * not there already.
+     */
+    interned_string intern(const std::u32string_view& value)
+    {
+      const auto guard = lock();
+      const auto it = m_entries.find(value);
+
+      if (it != std::end(m_entries))
+      {
+        return it->second;
+      }
+
+      return insert(interned_string(std::u32string(value), m_id));
+    }
+
+    /**
+     * Returns interned copy of given string, adding it to the table if it's
+     * not there already.
+     */
+    inline interned_string intern(const char32_t* value)
+    {
+      return intern(std::u32string_view(value));
+    }
+
+    /**
+     * Returns interned copy of given string, adding it to the table if it's
+     * not there already.
+     */
+    interned_string intern(std::u32string&& value)
+    {
+      const auto guard = lock();
+      const auto it = m_entries.find(value);
+
+      if (it != std::end(m_entries))
+      {
+        return it->second;
+      }
+
+      return insert(interned_string(std::move(value), m_id));
+    }
+
+    /**
+     * Returns number of distinct strings in the table.
+     */
+    inline std::size_t size() const
+    {
+      const auto guard = lock();
+
+      return m_entries.size();
+    }
+
+  private:
+    /**
+     * Returns identifier for a new table. Identifiers are never reused, so
+     * strings interned by a table which no longer exists are never mistaken
+     * for ones interned by another table.
+     */
+    static std::uint64_t next_id()
+    {
+      static std::atomic<std::uint64_t> counter(0);
+
+      return ++counter;
+    }
+
+    std::unique_lock<std::mutex> lock() const
+    {
+      if (m_mutex)
+      {
+        return std::unique_lock<std::mutex>(*m_mutex);
+      }
+
+      return std::unique_lock<std::mutex>();
+    }
+
+    interned_string insert(const interned_string& value)
+    {
+      // Key is a view to the interned character data, which is never moved.
+      m_entries.emplace(value.str(), value);
+
+      return value;
+    }
+
+    std::unordered_map<std::u32string_view, interned_string> m_entries;
+    std::unique_ptr<std::mutex> m_mutex;
+    std::uint64_t m_id;
+  };
+}
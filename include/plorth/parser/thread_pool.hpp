@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace plorth::parser
+{
+  /**
+   * Fixed size pool of worker threads, which is used to parse source code in
+   * parallel. Each worker has a queue of it's own. Tasks submitted from
+   * outside of the pool are distributed evenly between the queues, while
+   * tasks submitted by a worker are placed in the queue of that worker. Idle
+   * workers steal tasks from the queues of other workers, so that uneven
+   * tasks, such as files of different sizes, keep every worker busy.
+   *
+   * Tasks running in the pool must not wait for other tasks submitted to the
+   * same pool, as that might never finish if every worker is waiting.
+   */
+  class thread_pool
+  {
+  public:
+    /**
+     * Constructs thread pool and starts the worker threads.
+     *
+     * \param size Number of worker threads. If zero, one thread for each
+     *             hardware thread is started.
+     */
+    explicit thread_pool(std::size_t size = 0)
+      : m_next_queue(0)
+      , m_pending(0)
+      , m_stopping(false)
+    {
+      if (!size)
+      {
+        size = std::max(std::thread::hardware_concurrency(), 1u);
+      }
+      m_queues.reserve(size);
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        m_queues.push_back(std::make_unique<queue>());
+      }
+      m_workers.reserve(size);
+      for (std::size_t i = 0; i < size; ++i)
+      {
+        m_workers.emplace_back([this, i]() { work(i); });
+      }
+    }
+
+    /**
+     * Finishes the remaining tasks and stops the worker threads.
+     */
+    ~thread_pool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stopping = true;
+      }
+      m_condition.notify_all();
+      for (auto& worker : m_workers)
+      {
+        worker.join();
+      }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool(thread_pool&&) = delete;
+    void operator=(const thread_pool&) = delete;
+    void operator=(thread_pool&&) = delete;
+
+    /**
+     * Returns the number of worker threads in the pool.
+     */
+    inline std::size_t size() const
+    {
+      return m_workers.size();
+    }
+
+    /**
+     * Submits a task to be executed by one of the worker threads.
+     *
+     * \return Future which receives the value returned by the task, or the
+     *         exception thrown by it.
+     */
+    template<class FunctionT>
+    std::future<std::invoke_result_t<FunctionT>> submit(FunctionT&& function)
+    {
+      using result_type = std::invoke_result_t<FunctionT>;
+      auto task = std::make_shared<std::packaged_task<result_type()>>(
+        std::forward<FunctionT>(function)
+      );
+      auto future = task->get_future();
+      auto& queue = *m_queues[
+        current_worker().first == this
+          ? current_worker().second
+          : m_next_queue++ % m_queues.size()
+      ];
+
+      {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        queue.tasks.emplace_back([task]() { (*task)(); });
+      }
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ++m_pending;
+      }
+      m_condition.notify_one();
+
+      return future;
+    }
+
+  private:
+    struct queue
+    {
+      std::mutex mutex;
+      std::deque<std::function<void()>> tasks;
+    };
+
+    /**
+     * Returns the pool and index of the worker running in current thread.
+     */
+    static std::pair<const thread_pool*, std::size_t>& current_worker()
+    {
+      static thread_local std::pair<const thread_pool*, std::size_t> worker(
+        nullptr,
+        0
+      );
+
+      return worker;
+    }
+
+    /**
+     * Takes a task from the back of the worker's own queue, or steals one
+     * from the front of another worker's queue.
+     */
+    bool take(std::size_t index, std::function<void()>& task)
+    {
+      for (std::size_t i = 0; i < m_queues.size(); ++i)
+      {
+        auto& queue = *m_queues[(index + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty())
+        {
+          continue;
+        }
+        if (i == 0)
+        {
+          task = std::move(queue.tasks.back());
+          queue.tasks.pop_back();
+        } else {
+          task = std::move(queue.tasks.front());
+          queue.tasks.pop_front();
+        }
+
+        return true;
+      }
+
+      return false;
+    }
+
+    void work(std::size_t index)
+    {
+      current_worker() = { this, index };
+      for (;;)
+      {
+        std::function<void()> task;
+
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+
+          m_condition.wait(lock, [this]()
+          {
+            return m_stopping || m_pending > 0;
+          });
+          if (!m_pending)
+          {
+            return;
+          }
+        }
+        if (!take(index, task))
+        {
+          // Another worker took the task first.
+          std::this_thread::yield();
+          continue;
+        }
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+
+          --m_pending;
+        }
+        task();
+      }
+    }
+
+    std::vector<std::unique_ptr<queue>> m_queues;
+    std::vector<std::thread> m_workers;
+    std::atomic<std::size_t> m_next_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::size_t m_pending;
+    bool m_stopping;
+  };
+
+  namespace internal
+  {
+    template<class ResultT>
+    std::vector<ResultT> wait_all(std::vector<std::future<ResultT>>& futures)
+    {
+      std::vector<ResultT> results;
+
+      // Tasks refer to the caller's variables, so they must all finish
+      // before any exception thrown by one of them is passed on.
+      for (auto& future : futures)
+      {
+        future.wait();
+      }
+      results.reserve(futures.size());
+      for (auto& future : futures)
+      {
+        results.push_back(future.get());
+      }
+
+      return results;
+    }
+  }
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <iterator>
+#include <optional>
+
+#include <plorth/parser.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Range which parses top level tokens of a Plorth program lazily, one at a
+   * time, as it is being iterated. Unlike parse(), which returns only after
+   * the entire program has been parsed, this allows the caller to process
+   * each token, and to release it, before the rest of the program has been
+   * parsed.
+   *
+   * Each iteration yields result of parsing a single token. If an error is
+   * encountered, it is yielded as the last element of the range.
+   */
+  template<class IteratorT, class BuilderT = ast::builder<>>
+  class basic_token_stream
+  {
+    static_assert(
+      is_builder_v<BuilderT>,
+      "Builder does not provide the types and functions used by the parser."
+    );
+
+  public:
+    using builder_type = BuilderT;
+    using result_type = basic_parse_token_result<BuilderT>;
+
+    /**
+     * Input iterator over the top level tokens. Advancing the iterator
+     * parses the next token from the source code.
+     */
+    class iterator
+    {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = result_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type*;
+      using reference = const value_type&;
+
+      explicit iterator(basic_token_stream* stream = nullptr)
+        : m_stream(stream) {}
+
+      inline reference operator*() const
+      {
+        return *m_stream->m_current;
+      }
+
+      inline pointer operator->() const
+      {
+        return &*m_stream->m_current;
+      }
+
+      inline iterator& operator++()
+      {
+        if (!m_stream->advance())
+        {
+          m_stream = nullptr;
+        }
+
+        return *this;
+      }
+
+      inline void operator++(int)
+      {
+        ++*this;
+      }
+
+      inline bool operator==(const iterator& that) const
+      {
+        return m_stream == that.m_stream;
+      }
+
+      inline bool operator!=(const iterator& that) const
+      {
+        return m_stream != that.m_stream;
+      }
+
+    private:
+      basic_token_stream* m_stream;
+    };
+
+    /**
+     * Constructs token stream from given range of source code.
+     *
+     * \param current  Iterator pointing to beginning of the source code.
+     * \param end      Iterator pointing to end of the source code.
+     * \param position Position of the beginning of the source code.
+     * \param builder  Builder used to construct the AST tokens.
+     */
+    explicit basic_token_stream(
+      const IteratorT& current,
+      const IteratorT& end,
+      const struct position& position = {},
+      const builder_type& builder = builder_type()
+    )
+      : m_next(current)
+      , m_end(end)
+      , m_position(position)
+      , m_builder(builder)
+      , m_started(false)
+      , m_failed(false) {}
+
+    basic_token_stream(const basic_token_stream&) = delete;
+    void operator=(const basic_token_stream&) = delete;
+
+    /**
+     * Returns iterator pointing to the first token which has not yet been
+     * consumed. The stream can be iterated only once.
+     */
+    iterator begin()
+    {
+      if (!m_started)
+      {
+        m_started = true;
+        if (!advance())
+        {
+          return end();
+        }
+      }
+      else if (!m_current)
+      {
+        return end();
+      }
+
+      return iterator(this);
+    }
+
+    inline iterator end()
+    {
+      return iterator();
+    }
+
+    /**
+     * Returns position in the source code where parsing of the next token
+     * will begin, or where parsing failed.
+     */
+    inline const struct position& position() const
+    {
+      return m_position;
+    }
+
+  private:
+    /**
+     * Parses the next token. Returns false when there are no more tokens to
+     * be parsed, either because end of the source code has been reached or
+     * because an error was encountered.
+     */
+    bool advance()
+    {
+      m_current.reset();
+      if (m_failed || !(m_next < m_end))
+      {
+        return false;
+      }
+      m_current.emplace(parse_token(m_next, m_end, m_position, m_builder));
+      if (!*m_current)
+      {
+        m_failed = true;
+      }
+
+      return true;
+    }
+
+  private:
+    /** Iterator pointing to the beginning of the next token. */
+    IteratorT m_next;
+    /** Iterator pointing to the end of the source code. */
+    const IteratorT m_end;
+    /** Current position in the source code. */
+    struct position m_position;
+    /** Builder used to construct the AST tokens. */
+    const builder_type m_builder;
+    /** Result of parsing the current token. */
+    std::optional<result_type> m_current;
+    /** Whether the first token has been parsed. */
+    bool m_started;
+    /** Whether an error has been encountered. */
+    bool m_failed;
+  };
+
+  /**
+   * Returns range which lazily parses top level tokens from given UTF-8
+   * encoded source code. The source code must outlive the range.
+   *
+   * \param source   UTF-8 encoded source code.
+   * \param position Position of the beginning of the source code.
+   * \param builder  Builder used to construct the AST tokens.
+   */
+  template<class BuilderT = ast::builder<>>
+  basic_token_stream<utf8::iterator<>, BuilderT> parse_lazily(
+    const std::string_view& source,
+    const struct position& position = {},
+    const BuilderT& builder = BuilderT()
+  )
+  {
+    return basic_token_stream<utf8::iterator<>, BuilderT>(
+      utf8::begin(source),
+      utf8::end(source),
+      position,
+      builder
+    );
+  }
+}
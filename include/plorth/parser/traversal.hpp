@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+#include <plorth/parser/ast.hpp>
+
+namespace plorth::parser::ast
+{
+  /**
+   * Order in which traversal visits the tokens.
+   */
+  enum class traversal_order
+  {
+    /** Each token is visited before it's children. */
+    pre_order,
+    /** Each token is visited after it's children. */
+    post_order
+  };
+
+  /**
+   * Range which visits given tokens and every token nested inside them, in
+   * depth first order, without recursion. Elements of arrays, values of
+   * object properties and children of quotes are visited in the order they
+   * appear in the source code. Symbol of a word definition is visited as
+   * the only child of the word, like in a flat::tree.
+   *
+   * The path from the top level to the current token is kept in an explicit
+   * stack owned by the range, so arbitrarily deep trees can be traversed.
+   * Memory allocated for the stack is retained when the range is traversed
+   * again, so repeated traversals do not allocate.
+   */
+  template<traversal_order Order>
+  class basic_traversal
+  {
+  public:
+    using container_type = std::vector<std::shared_ptr<token>>;
+
+    class iterator
+    {
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = std::shared_ptr<token>;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const value_type*;
+      using reference = const value_type&;
+
+      explicit iterator(basic_traversal* traversal = nullptr)
+        : m_traversal(traversal) {}
+
+      inline reference operator*() const
+      {
+        return m_traversal->current();
+      }
+
+      inline pointer operator->() const
+      {
+        return &m_traversal->current();
+      }
+
+      inline iterator& operator++()
+      {
+        if (!m_traversal->advance())
+        {
+          m_traversal = nullptr;
+        }
+
+        return *this;
+      }
+
+      inline bool operator==(const iterator& that) const
+      {
+        return m_traversal == that.m_traversal;
+      }
+
+      inline bool operator!=(const iterator& that) const
+      {
+        return m_traversal != that.m_traversal;
+      }
+
+    private:
+      basic_traversal* m_traversal;
+    };
+
+    /**
+     * Constructs traversal over given top level tokens, such as the ones
+     * returned by parse(). The tokens must outlive the traversal.
+     */
+    explicit basic_traversal(const container_type& roots)
+      : m_roots(roots.data())
+      , m_size(roots.size())
+      , m_pruned(false) {}
+
+    /**
+     * Constructs traversal over given token and the tokens nested inside
+     * it. The token must outlive the traversal.
+     */
+    explicit basic_traversal(const std::shared_ptr<token>& root)
+      : m_roots(&root)
+      , m_size(1)
+      , m_pruned(false) {}
+
+    basic_traversal(const basic_traversal&) = delete;
+    void operator=(const basic_traversal&) = delete;
+
+    /**
+     * Starts the traversal from the beginning.
+     */
+    iterator begin()
+    {
+      m_stack.clear();
+      m_pruned = false;
+      if (!m_size)
+      {
+        return end();
+      }
+      m_stack.push_back({ nullptr, 0 });
+      if constexpr (Order == traversal_order::post_order)
+      {
+        descend();
+      }
+
+      return iterator(this);
+    }
+
+    inline iterator end()
+    {
+      return iterator();
+    }
+
+    /**
+     * Returns number of arrays, objects, quotes and word definitions the
+     * current token is nested inside of.
+     */
+    inline std::size_t depth() const
+    {
+      return m_stack.size() - 1;
+    }
+
+    /**
+     * Prevents tokens nested inside the current token from being visited.
+     * Only available in pre-order traversal, since in post-order traversal
+     * they have already been visited.
+     */
+    inline void skip_children()
+    {
+      static_assert(Order == traversal_order::pre_order);
+      m_pruned = true;
+    }
+
+  private:
+    /**
+     * Container token whose children are being visited, and index of the
+     * child currently being visited. Top level tokens have null parent.
+     */
+    struct frame
+    {
+      const token* parent;
+      std::size_t index;
+    };
+
+    static std::size_t size(const token& parent)
+    {
+      switch (parent.type())
+      {
+        case token::type::array:
+          return static_cast<const array&>(parent).elements().size();
+
+        case token::type::object:
+          return static_cast<const object&>(parent).properties().size();
+
+        case token::type::quote:
+          return static_cast<const quote&>(parent).children().size();
+
+        case token::type::word:
+          return static_cast<const word&>(parent).symbol() ? 1 : 0;
+
+        default:
+          return 0;
+      }
+    }
+
+    inline std::size_t size(const frame& frame) const
+    {
+      return frame.parent ? size(*frame.parent) : m_size;
+    }
+
+    inline const std::shared_ptr<token>& current() const
+    {
+      const auto& top = m_stack.back();
+
+      if (!top.parent)
+      {
+        return m_roots[top.index];
+      }
+
+      switch (top.parent->type())
+      {
+        case token::type::array:
+          return static_cast<const array&>(*top.parent)
+            .elements()[top.index];
+
+        case token::type::object:
+          return static_cast<const object&>(*top.parent)
+            .properties()[top.index].second;
+
+        case token::type::word:
+          return m_symbol;
+
+        default:
+          return static_cast<const quote&>(*top.parent)
+            .children()[top.index];
+      }
+    }
+
+    /**
+     * Starts visiting children of given token.
+     */
+    void push(const std::shared_ptr<token>& token)
+    {
+      // Symbol is stored as a pointer to a symbol, so a pointer to a token
+      // has to be kept for current() to refer to. Word definitions cannot
+      // be nested, so one is enough.
+      if (token->type() == token::type::word)
+      {
+        m_symbol = static_cast<const word&>(*token).symbol();
+      }
+      m_stack.push_back({ token.get(), 0 });
+    }
+
+    /**
+     * Descends from the current token to it's first descendant which has
+     * no children.
+     */
+    void descend()
+    {
+      for (;;)
+      {
+        const auto& token = current();
+
+        if (!token || !size(*token))
+        {
+          break;
+        }
+        push(token);
+      }
+    }
+
+    /**
+     * Moves to the next token. Returns false when all tokens have been
+     * visited.
+     */
+    bool advance()
+    {
+      if constexpr (Order == traversal_order::pre_order)
+      {
+        const auto& token = current();
+
+        if (!m_pruned && token && size(*token))
+        {
+          push(token);
+
+          return true;
+        }
+        m_pruned = false;
+        while (++m_stack.back().index >= size(m_stack.back()))
+        {
+          m_stack.pop_back();
+          if (m_stack.empty())
+          {
+            return false;
+          }
+        }
+      } else {
+        if (++m_stack.back().index < size(m_stack.back()))
+        {
+          descend();
+        } else {
+          m_stack.pop_back();
+          if (m_stack.empty())
+          {
+            return false;
+          }
+        }
+      }
+
+      return true;
+    }
+
+  private:
+    /** Top level tokens. */
+    const std::shared_ptr<token>* m_roots;
+    /** Number of top level tokens. */
+    std::size_t m_size;
+    /** Path from the top level to the current token. */
+    std::vector<frame> m_stack;
+    /** Whether children of the current token should be skipped. */
+    bool m_pruned;
+    /** Symbol of the word definition being visited. */
+    std::shared_ptr<token> m_symbol;
+  };
+
+  using pre_order_traversal = basic_traversal<traversal_order::pre_order>;
+  using post_order_traversal = basic_traversal<traversal_order::post_order>;
+}
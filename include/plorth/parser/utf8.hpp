@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2026, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace plorth::parser::utf8
+{
+  /**
+   * Code point returned when the input contains malformed UTF-8.
+   */
+  static constexpr char32_t replacement_character = 0xfffd;
+
+  /**
+   * Returns the number of bytes in UTF-8 sequence which begins with given
+   * lead byte, or 1 if the byte cannot begin a multi-byte sequence.
+   */
+  inline std::size_t sequence_length(unsigned char lead)
+  {
+    if ((lead & 0xe0) == 0xc0)
+    {
+      return 2;
+    }
+    else if ((lead & 0xf0) == 0xe0)
+    {
+      return 3;
+    }
+    else if ((lead & 0xf8) == 0xf0)
+    {
+      return 4;
+    }
+
+    return 1;
+  }
+
+  /**
+   * Decodes single UTF-8 sequence from given byte range.
+   *
+   * Malformed sequences (invalid lead bytes, missing or invalid continuation
+   * bytes, overlong encodings, surrogates and values beyond U+10FFFF) are
+   * decoded as U+FFFD, consuming exactly one byte so that decoding can be
+   * resumed from the next byte.
+   *
+   * \param current Iterator pointing to first byte of the sequence.
+   * \param end     Iterator pointing to end of the input.
+   * \param length  Receives number of bytes consumed by the sequence.
+   * \return Decoded code point.
+   */
+  template<class ByteIteratorT>
+  inline char32_t decode(
+    const ByteIteratorT& current,
+    const ByteIteratorT& end,
+    std::size_t& length
+  )
+  {
+    const auto lead = static_cast<unsigned char>(*current);
+    char32_t result;
+    char32_t minimum;
+
+    length = 1;
+
+    if (lead < 0x80)
+    {
+      return lead;
+    }
+    else if ((lead & 0xe0) == 0xc0)
+    {
+      result = lead & 0x1f;
+      minimum = 0x80;
+      length = 2;
+    }
+    else if ((lead & 0xf0) == 0xe0)
+    {
+      result = lead & 0x0f;
+      minimum = 0x800;
+      length = 3;
+    }
+    else if ((lead & 0xf8) == 0xf0)
+    {
+      result = lead & 0x07;
+      minimum = 0x10000;
+      length = 4;
+    } else {
+      return replacement_character;
+    }
+
+    auto it = current;
+
+    for (std::size_t i = 1; i < length; ++i)
+    {
+      if (++it == end || (static_cast<unsigned char>(*it) & 0xc0) != 0x80)
+      {
+        length = 1;
+
+        return replacement_character;
+      }
+      result = (result << 6) | (static_cast<unsigned char>(*it) & 0x3f);
+    }
+
+    if (result < minimum
+        || result > 0x10ffff
+        || (result >= 0xd800 && result <= 0xdfff))
+    {
+      length = 1;
+
+      return replacement_character;
+    }
+
+    return result;
+  }
+
+  /**
+   * Decodes entire UTF-8 encoded string into UTF-32.
+   */
+  inline std::u32string decode(const std::string_view& input)
+  {
+    const auto end = std::cend(input);
+    std::u32string result;
+
+    result.reserve(input.length());
+    for (auto current = std::cbegin(input); current < end;)
+    {
+      std::size_t length;
+
+      result.append(1, decode(current, end, length));
+      current += length;
+    }
+
+    return result;
+  }
+
+  /**
+   * Iterator which decodes UTF-8 encoded input into Unicode code points on
+   * the fly, allowing the parser to consume UTF-8 input directly without
+   * decoding the whole source code into UTF-32 first.
+   *
+   * Comparison and difference of two iterators operate on the underlying
+   * bytes, so the distance between two iterators is measured in bytes.
+   */
+  template<class ByteIteratorT = const char*>
+  class iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = char32_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char32_t*;
+    using reference = char32_t;
+
+    iterator() = default;
+
+    /**
+     * Constructs iterator pointing to given byte in the input.
+     *
+     * \param current Iterator pointing to current byte of the input.
+     * \param end     Iterator pointing to end of the input.
+     */
+    explicit iterator(
+      const ByteIteratorT& current,
+      const ByteIteratorT& end
+    )
+      : m_current(current)
+      , m_end(end) {}
+
+    /**
+     * Returns iterator to the underlying byte.
+     */
+    inline const ByteIteratorT& base() const
+    {
+      return m_current;
+    }
+
+    inline char32_t operator*() const
+    {
+      std::size_t length;
+
+      return decode(m_current, m_end, length);
+    }
+
+    inline iterator& operator++()
+    {
+      if (static_cast<unsigned char>(*m_current) < 0x80)
+      {
+        ++m_current;
+      } else {
+        std::size_t length;
+
+        decode(m_current, m_end, length);
+        std::advance(m_current, length);
+      }
+
+      return *this;
+    }
+
+    inline iterator operator++(int)
+    {
+      const auto previous = *this;
+
+      ++(*this);
+
+      return previous;
+    }
+
+    inline difference_type operator-(const iterator& that) const
+    {
+      return std::distance(that.m_current, m_current);
+    }
+
+    inline bool operator==(const iterator& that) const
+    {
+      return m_current == that.m_current;
+    }
+
+    inline bool operator!=(const iterator& that) const
+    {
+      return m_current != that.m_current;
+    }
+
+    inline bool operator<(const iterator& that) const
+    {
+      return m_current < that.m_current;
+    }
+
+    inline bool operator<=(const iterator& that) const
+    {
+      return m_current <= that.m_current;
+    }
+
+    inline bool operator>(const iterator& that) const
+    {
+      return m_current > that.m_current;
+    }
+
+    inline bool operator>=(const iterator& that) const
+    {
+      return m_current >= that.m_current;
+    }
+
+  private:
+    ByteIteratorT m_current;
+    ByteIteratorT m_end;
+  };
+
+  /**
+   * Returns decoding iterator pointing to beginning of given UTF-8 input.
+   */
+  inline iterator<> begin(const std::string_view& input)
+  {
+    return iterator<>(input.data(), input.data() + input.length());
+  }
+
+  /**
+   * Returns decoding iterator pointing to end of given UTF-8 input.
+   */
+  inline iterator<> end(const std::string_view& input)
+  {
+    const auto end = input.data() + input.length();
+
+    return iterator<>(end, end);
+  }
+}
@@ -25,22 +25,167 @@
  */
 #pragma once
 
-#include <cctype>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
 #include <peelo/unicode/ctype/isgraph.hpp>
+#include <peelo/unicode/ctype/isspace.hpp>
 #include <plorth/parser/position.hpp>
+#include <plorth/parser/scan.hpp>
+#include <plorth/parser/utf8.hpp>
 
 namespace plorth::parser::utils
 {
+  /**
+   * Bit flags describing classes of ASCII characters in the source code.
+   */
+  enum ascii_class : std::uint8_t
+  {
+    /** Whitespace. */
+    ascii_whitespace = 1 << 0,
+    /** Character which can be part of a symbol. */
+    ascii_word = 1 << 1,
+    /** Character which separates tokens from each other. */
+    ascii_delimiter = 1 << 2,
+    /** Character which begins a string literal. */
+    ascii_quote = 1 << 3,
+    /** Character which begins a comment. */
+    ascii_comment = 1 << 4
+  };
+
+  namespace internal
+  {
+    constexpr std::array<std::uint8_t, 256> make_ascii_class_table()
+    {
+      std::array<std::uint8_t, 256> table = {};
+
+      for (int c = '\t'; c <= '\r'; ++c)
+      {
+        table[c] |= ascii_whitespace;
+      }
+      table[' '] |= ascii_whitespace;
+      for (int c = '!'; c <= '~'; ++c)
+      {
+        table[c] |= ascii_word;
+      }
+      for (const auto c : { '(', ')', '[', ']', '{', '}', ',' })
+      {
+        table[c] = ascii_delimiter;
+      }
+      table['"'] |= ascii_quote;
+      table['\''] |= ascii_quote;
+      table['#'] |= ascii_comment;
+
+      return table;
+    }
+  }
+
+  /**
+   * Classes of characters indexed by their code point. Only ASCII
+   * characters are classified; entries above 127 are left empty and
+   * characters outside ASCII must be classified with the Unicode tables
+   * instead.
+   */
+  inline constexpr std::array<std::uint8_t, 256> ascii_class_table =
+    internal::make_ascii_class_table();
+
+  /**
+   * Returns true if given character is whitespace. ASCII characters are
+   * classified with a lookup table and other characters with the Unicode
+   * character database.
+   */
+  inline bool isspace(char32_t c)
+  {
+    if (c < 128)
+    {
+      return ascii_class_table[c] & ascii_whitespace;
+    }
+
+    return peelo::unicode::ctype::isspace(c);
+  }
+
+  /**
+   * Returns true if given character can be part of a symbol. ASCII
+   * characters are classified with a lookup table and other characters with
+   * the Unicode character database.
+   */
+  inline bool isword(char32_t c)
+  {
+    if (c < 128)
+    {
+      return ascii_class_table[c] & ascii_word;
+    }
+
+    return peelo::unicode::ctype::isgraph(c);
+  }
+
+  /**
+   * Tells whether given iterator type iterates over UTF-32 encoded source
+   * code stored in contiguous memory, which allows the parser to refer to
+   * the source code directly instead of copying parts of it.
+   */
+  template<class IteratorT>
+  inline constexpr bool is_contiguous_v =
+    std::is_same_v<IteratorT, const char32_t*>
+    || std::is_same_v<IteratorT, char32_t*>
+    || std::is_same_v<IteratorT, std::u32string::const_iterator>
+    || std::is_same_v<IteratorT, std::u32string::iterator>
+    || std::is_same_v<IteratorT, std::u32string_view::const_iterator>;
+
+  /**
+   * Returns view to the source code between the two given iterators, which
+   * must iterate over source code stored in contiguous memory.
+   */
+  template<class IteratorT>
+  inline std::u32string_view slice(
+    const IteratorT& begin,
+    const IteratorT& end
+  )
+  {
+    static_assert(is_contiguous_v<IteratorT>);
+
+    if (begin < end)
+    {
+      return std::u32string_view(&*begin, end - begin);
+    }
+
+    return std::u32string_view();
+  }
+
+  /**
+   * Returns true if source code between the two given iterators is equal to
+   * given string.
+   */
+  template<class IteratorT>
+  inline bool equals(IteratorT begin, const IteratorT& end, const char32_t* s)
+  {
+    for (; begin < end; ++begin, ++s)
+    {
+      if (!*s || *begin != *s)
+      {
+        return false;
+      }
+    }
+
+    return !*s;
+  }
+
   /**
    * Advances to the next character in source code and returns the current one
-   * while updating the position.
+   * while updating the position. When `PLORTH_PARSER_OFFSETS_ONLY` is
+   * defined, only the offset is updated.
    */
   template<class IteratorT>
   inline char32_t advance(IteratorT& current, struct position& position)
   {
+    const auto previous = current;
     const auto c = *current++;
 
+    position.offset += current - previous;
+#if !defined(PLORTH_PARSER_OFFSETS_ONLY)
     if (c == '\n')
     {
       ++position.line;
@@ -48,10 +193,66 @@ namespace plorth::parser::utils
     } else {
       ++position.column;
     }
+#endif
 
     return c;
   }
 
+  /**
+   * Advances over a run of characters found with given scanning kernel,
+   * while updating the position in bulk. The run must not contain line
+   * breaks. Does nothing unless the source code is stored in contiguous
+   * memory, either as UTF-32, in which case the kernel is used, or as
+   * UTF-8, in which case the byte kernel is used if one is given.
+   *
+   * \return Number of characters advanced over.
+   */
+  template<class IteratorT, class KernelT, class ByteKernelT = std::nullptr_t>
+  inline std::ptrdiff_t advance_run(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position,
+    KernelT kernel,
+    ByteKernelT byte_kernel = nullptr
+  )
+  {
+    if constexpr (is_contiguous_v<IteratorT>)
+    {
+      if (current < end)
+      {
+        const char32_t* first = &*current;
+        const auto length = kernel(first, first + (end - current)) - first;
+
+        current += length;
+        position.offset += length;
+#if !defined(PLORTH_PARSER_OFFSETS_ONLY)
+        position.column += length;
+#endif
+
+        return length;
+      }
+    }
+    else if constexpr (std::is_same_v<IteratorT, utf8::iterator<>>
+        && !std::is_null_pointer_v<ByteKernelT>)
+    {
+      if (current < end)
+      {
+        const auto first = current.base();
+        const auto length = byte_kernel(first, end.base()) - first;
+
+        current = IteratorT(first + length, end.base());
+        position.offset += length;
+#if !defined(PLORTH_PARSER_OFFSETS_ONLY)
+        position.column += length;
+#endif
+
+        return length;
+      }
+    }
+
+    return 0;
+  }
+
   /**
    * Returns true if next character to be read from source code matches with
    * one given as argument.
@@ -106,6 +307,13 @@ namespace plorth::parser::utils
       // Skip line comments.
       if (peek_advance(current, end, position, '#'))
       {
+        advance_run(
+          current,
+          end,
+          position,
+          scan::find_line_end,
+          scan::ascii::find_line_end
+        );
         while (current < end)
         {
           if (peek_advance(current, end, position, '\n')
@@ -117,21 +325,21 @@ namespace plorth::parser::utils
           }
         }
       }
-      else if (current < end && !std::isspace(*current))
+      else if (current < end && !isspace(*current))
       {
         return false;
       } else {
         advance(current, position);
+        advance_run(
+          current,
+          end,
+          position,
+          scan::skip_blanks,
+          scan::ascii::skip_blanks
+        );
       }
     }
 
     return true;
   }
-
-  static inline bool isword(char32_t c)
-  {
-    return c != '(' && c != ')' && c != '[' && c != ']' && c != '{'
-      && c != '}' && c != ','
-      && peelo::unicode::ctype::isgraph(c);
-  }
 }
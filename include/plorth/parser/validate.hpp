@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <plorth/parser/events.hpp>
+
+namespace plorth::parser
+{
+  /**
+   * Checks whether given source code is a syntactically valid Plorth
+   * program, without constructing any values from it. Grammar of the source
+   * code is checked exactly as by parse(), and the same error is returned
+   * for invalid source code, but contents of string literals, symbols and
+   * object keys are not decoded nor copied. Only a stack of currently open
+   * arrays, objects and quotes is allocated.
+   *
+   * \param current  Iterator pointing to current position in source code.
+   * \param end      Iterator pointing to end of the source code.
+   * \param position Current source code position.
+   * \return         Error if the source code is not valid.
+   */
+  template<class IteratorT>
+  std::optional<error> validate(
+    IteratorT& current,
+    const IteratorT& end,
+    struct position& position
+  )
+  {
+    event_handler handler;
+    internal::event_adapter<event_handler> adapter(handler);
+
+    return internal::parse_events<false>(current, end, position, adapter);
+  }
+
+  /**
+   * Checks whether given UTF-8 encoded source code is a syntactically valid
+   * Plorth program, without constructing any values from it.
+   *
+   * \param source   UTF-8 encoded source code.
+   * \param position Current source code position.
+   * \return         Error if the source code is not valid.
+   */
+  inline std::optional<error> validate(
+    const std::string_view& source,
+    struct position& position
+  )
+  {
+    auto current = utf8::begin(source);
+    const auto end = utf8::end(source);
+
+    return validate(current, end, position);
+  }
+}
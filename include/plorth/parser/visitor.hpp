@@ -25,6 +25,8 @@
  */
 #pragma once
 
+#include <utility>
+
 #include <plorth/parser/ast.hpp>
 
 namespace plorth::parser::ast
@@ -124,4 +126,130 @@ namespace plorth::parser::ast
       }
     }
   };
+
+  /**
+   * Visitor which dispatches on type of the token at compile time, using the
+   * curiously recurring template pattern. Derived class hides the visit_*
+   * methods it is interested in, and they are called with the token as a
+   * reference of it's concrete type, without copying any shared pointers or
+   * making virtual calls. Additional arguments given to visit() are
+   * forwarded to the methods as they are.
+   *
+   * Methods which are not hidden by the derived class forward to
+   * visit_token(), which does nothing and returns a value initialized
+   * result by default.
+   */
+  template<class DerivedT, class ResultT = void>
+  class static_visitor
+  {
+  public:
+    using result_type = ResultT;
+
+    template<class... Args>
+    inline result_type visit(const token& token, Args&&... args)
+    {
+      switch (token.type())
+      {
+        case token::type::array:
+          return self().visit_array(
+            static_cast<const array&>(token),
+            std::forward<Args>(args)...
+          );
+
+        case token::type::object:
+          return self().visit_object(
+            static_cast<const object&>(token),
+            std::forward<Args>(args)...
+          );
+
+        case token::type::quote:
+          return self().visit_quote(
+            static_cast<const quote&>(token),
+            std::forward<Args>(args)...
+          );
+
+        case token::type::string:
+          return self().visit_string(
+            static_cast<const string&>(token),
+            std::forward<Args>(args)...
+          );
+
+        case token::type::symbol:
+          return self().visit_symbol(
+            static_cast<const symbol&>(token),
+            std::forward<Args>(args)...
+          );
+
+        case token::type::word:
+          return self().visit_word(
+            static_cast<const word&>(token),
+            std::forward<Args>(args)...
+          );
+      }
+
+      return result_type();
+    }
+
+    template<class... Args>
+    inline result_type visit(
+      const std::shared_ptr<token>& token,
+      Args&&... args
+    )
+    {
+      if (!token)
+      {
+        return result_type();
+      }
+
+      return visit(*token, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    inline result_type visit_array(const array& token, Args&&... args)
+    {
+      return self().visit_token(token, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    inline result_type visit_object(const object& token, Args&&... args)
+    {
+      return self().visit_token(token, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    inline result_type visit_quote(const quote& token, Args&&... args)
+    {
+      return self().visit_token(token, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    inline result_type visit_string(const string& token, Args&&... args)
+    {
+      return self().visit_token(token, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    inline result_type visit_symbol(const symbol& token, Args&&... args)
+    {
+      return self().visit_token(token, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    inline result_type visit_word(const word& token, Args&&... args)
+    {
+      return self().visit_token(token, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    inline result_type visit_token(const token&, Args&&...)
+    {
+      return result_type();
+    }
+
+  private:
+    inline DerivedT& self()
+    {
+      return static_cast<DerivedT&>(*this);
+    }
+  };
 }
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2020, Rauli Laine
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <plorth/parser/traversal.hpp>
+#include <plorth/parser/visitor.hpp>
+
+namespace plorth::parser::ast
+{
+  /**
+   * Set of token types, as a bit mask.
+   */
+  using token_type_mask = std::uint8_t;
+
+  namespace internal
+  {
+    /**
+     * Returns index of given token type, between zero and five.
+     */
+    inline constexpr std::size_t type_index(enum token::type type)
+    {
+      switch (type)
+      {
+        case token::type::array:
+          return 0;
+
+        case token::type::object:
+          return 1;
+
+        case token::type::quote:
+          return 2;
+
+        case token::type::string:
+          return 3;
+
+        case token::type::symbol:
+          return 4;
+
+        default:
+          return 5;
+      }
+    }
+  }
+
+  /**
+   * Returns mask which contains given token types.
+   */
+  template<class... Types>
+  inline constexpr token_type_mask type_mask(Types... types)
+  {
+    return static_cast<token_type_mask>(
+      (0u | ... | (1u << internal::type_index(types)))
+    );
+  }
+
+  /**
+   * Mask which contains every token type.
+   */
+  inline constexpr token_type_mask all_types = 0x3f;
+
+  /**
+   * Runs multiple visitors over the AST in a single traversal, instead of
+   * each of them walking the whole tree separately. Every token in the tree,
+   * including the ones nested inside arrays, objects and quotes and symbols
+   * of word definitions, is given to each visitor whose type mask contains
+   * type of the token. Visitors should therefore not descend into the tokens
+   * themselves.
+   *
+   * Visitors are called in the order they were added. The runner does not
+   * own the visitors, so they must outlive it.
+   */
+  template<class... Args>
+  class visitor_runner
+  {
+  public:
+    using visitor_type = visitor<Args...>;
+
+    /**
+     * Adds visitor to the runner.
+     *
+     * \param visitor Visitor to be added.
+     * \param mask    Types of tokens the visitor is interested in. It won't
+     *                be called for other tokens.
+     */
+    void add(const visitor_type& visitor, token_type_mask mask = all_types)
+    {
+      for (std::size_t i = 0; i < m_visitors.size(); ++i)
+      {
+        if (mask & (1u << i))
+        {
+          m_visitors[i].push_back(&visitor);
+        }
+      }
+    }
+
+    /**
+     * Runs the visitors over given tokens, such as the ones returned by
+     * parse(), and every token nested inside them.
+     */
+    void run(
+      const std::vector<std::shared_ptr<token>>& tokens,
+      Args... args
+    ) const
+    {
+      pre_order_traversal traversal(tokens);
+
+      run(traversal, args...);
+    }
+
+    /**
+     * Runs the visitors over given token and every token nested inside it.
+     */
+    void run(const std::shared_ptr<token>& token, Args... args) const
+    {
+      pre_order_traversal traversal(token);
+
+      run(traversal, args...);
+    }
+
+  private:
+    void run(pre_order_traversal& traversal, Args... args) const
+    {
+      for (const auto& token : traversal)
+      {
+        if (!token)
+        {
+          continue;
+        }
+
+        const auto type = token->type();
+        const auto& visitors = m_visitors[internal::type_index(type)];
+
+        if (visitors.empty())
+        {
+          continue;
+        }
+
+        switch (type)
+        {
+          case token::type::array:
+            dispatch<array>(
+              visitors,
+              token,
+              &visitor_type::visit_array,
+              args...
+            );
+            break;
+
+          case token::type::object:
+            dispatch<object>(
+              visitors,
+              token,
+              &visitor_type::visit_object,
+              args...
+            );
+            break;
+
+          case token::type::quote:
+            dispatch<quote>(
+              visitors,
+              token,
+              &visitor_type::visit_quote,
+              args...
+            );
+            break;
+
+          case token::type::string:
+            dispatch<string>(
+              visitors,
+              token,
+              &visitor_type::visit_string,
+              args...
+            );
+            break;
+
+          case token::type::symbol:
+            dispatch<symbol>(
+              visitors,
+              token,
+              &visitor_type::visit_symbol,
+              args...
+            );
+            break;
+
+          case token::type::word:
+            dispatch<word>(
+              visitors,
+              token,
+              &visitor_type::visit_word,
+              args...
+            );
+            break;
+        }
+      }
+    }
+
+    /**
+     * Casts the token into it's concrete type once, and gives it to each of
+     * the visitors.
+     */
+    template<class T, class MethodT>
+    static void dispatch(
+      const std::vector<const visitor_type*>& visitors,
+      const std::shared_ptr<token>& token,
+      MethodT method,
+      Args... args
+    )
+    {
+      const auto concrete = std::static_pointer_cast<T>(token);
+
+      for (const auto visitor : visitors)
+      {
+        (visitor->*method)(concrete, args...);
+      }
+    }
+
+  private:
+    /** Visitors interested in each token type, indexed by type_index(). */
+    std::array<std::vector<const visitor_type*>, 6> m_visitors;
+  };
+}
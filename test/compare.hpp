@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cassert>
+
+#include <plorth/parser/ast.hpp>
+
+// Asserts that two tokens, and every token nested inside them, are of same
+// types, have same positions and spans and same values.
+inline void
+compare(
+  const std::shared_ptr<plorth::parser::ast::token>& a,
+  const std::shared_ptr<plorth::parser::ast::token>& b
+)
+{
+  using plorth::parser::ast::array;
+  using plorth::parser::ast::object;
+  using plorth::parser::ast::quote;
+  using plorth::parser::ast::string;
+  using plorth::parser::ast::symbol;
+  using plorth::parser::ast::token;
+  using plorth::parser::ast::word;
+
+  assert(a->type() == b->type());
+  assert(a->position().line == b->position().line);
+  assert(a->position().column == b->position().column);
+  assert(a->position().offset == b->position().offset);
+  assert(a->span().end == b->span().end);
+
+  switch (a->type())
+  {
+    case token::type::array:
+    {
+      const auto& x = std::static_pointer_cast<array>(a)->elements();
+      const auto& y = std::static_pointer_cast<array>(b)->elements();
+
+      assert(x.size() == y.size());
+      for (std::size_t i = 0; i < x.size(); ++i)
+      {
+        compare(x[i], y[i]);
+      }
+      break;
+    }
+
+    case token::type::object:
+    {
+      const auto& x = std::static_pointer_cast<object>(a)->properties();
+      const auto& y = std::static_pointer_cast<object>(b)->properties();
+
+      assert(x.size() == y.size());
+      for (std::size_t i = 0; i < x.size(); ++i)
+      {
+        assert(x[i].first == y[i].first);
+        compare(x[i].second, y[i].second);
+      }
+      break;
+    }
+
+    case token::type::quote:
+    {
+      const auto& x = std::static_pointer_cast<quote>(a)->children();
+      const auto& y = std::static_pointer_cast<quote>(b)->children();
+
+      assert(x.size() == y.size());
+      for (std::size_t i = 0; i < x.size(); ++i)
+      {
+        compare(x[i], y[i]);
+      }
+      break;
+    }
+
+    case token::type::string:
+      assert(
+        std::static_pointer_cast<string>(a)->value()
+        == std::static_pointer_cast<string>(b)->value()
+      );
+      break;
+
+    case token::type::symbol:
+      assert(
+        std::static_pointer_cast<symbol>(a)->id()
+        == std::static_pointer_cast<symbol>(b)->id()
+      );
+      break;
+
+    case token::type::word:
+      compare(
+        std::static_pointer_cast<word>(a)->symbol(),
+        std::static_pointer_cast<word>(b)->symbol()
+      );
+      break;
+  }
+}
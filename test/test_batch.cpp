@@ -0,0 +1,142 @@
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+
+#include <plorth/parser/batch.hpp>
+
+using plorth::parser::ast::symbol;
+
+static std::string
+write_file(const std::string& name, const std::string& contents)
+{
+  const auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream stream(path, std::ios::out | std::ios::binary);
+
+  stream << contents;
+
+  return path.string();
+}
+
+static void
+test_mapped_file()
+{
+  const auto path = write_file("plorth-test-mapped.plorth", "foo bar");
+  const auto empty_path = write_file("plorth-test-empty.plorth", "");
+  const plorth::parser::mapped_file file(path);
+  const plorth::parser::mapped_file empty(empty_path);
+  const plorth::parser::mapped_file missing("/nonexistent/file.plorth");
+
+  assert(file.is_open());
+  assert(file.view() == "foo bar");
+  assert(empty.is_open());
+  assert(empty.view().empty());
+  assert(!missing.is_open());
+
+  std::filesystem::remove(path);
+  std::filesystem::remove(empty_path);
+}
+
+static void
+test_parse_files()
+{
+  plorth::parser::thread_pool pool(3);
+  plorth::parser::symbol_table table(true);
+  std::vector<std::string> paths;
+
+  for (int i = 0; i < 20; ++i)
+  {
+    paths.push_back(write_file(
+      "plorth-test-" + std::to_string(i) + ".plorth",
+      "shared (dup) -> word-" + std::to_string(i)
+    ));
+  }
+  paths.push_back("/nonexistent/file.plorth");
+
+  const auto results = plorth::parser::parse_files(
+    paths,
+    pool,
+    plorth::parser::ast::builder<>(table)
+  );
+
+  assert(results.size() == paths.size());
+  for (int i = 0; i < 20; ++i)
+  {
+    const auto& result = results[i];
+
+    assert(!!result);
+    assert(result->size() == 3);
+    assert(
+      result->at(0)->position().file
+      == plorth::parser::utf8::decode(paths[i])
+    );
+    assert(
+      std::static_pointer_cast<symbol>(result->at(0))->id().id()
+      == std::static_pointer_cast<symbol>(results[0]->at(0))->id().id()
+    );
+    std::filesystem::remove(paths[i]);
+  }
+  assert(!results.back());
+  assert(results.back().error().message == U"Unable to open file.");
+  assert(table.size() == 22);
+}
+
+static void
+test_parse_batch()
+{
+  plorth::parser::thread_pool pool(2);
+  const std::string a = "foo bar";
+  const std::string b = "[1, 2";
+  const auto results = plorth::parser::parse_batch(
+    {
+      { U"a.plorth", a },
+      { U"b.plorth", b }
+    },
+    pool
+  );
+
+  assert(results.size() == 2);
+  assert(!!results[0]);
+  assert(results[0]->size() == 2);
+  assert(results[0]->at(1)->position().file == U"a.plorth");
+  assert(!results[1]);
+  assert(results[1].error().position.file == U"b.plorth");
+}
+
+static void
+test_work_stealing()
+{
+  plorth::parser::thread_pool pool(4);
+  std::atomic<int> counter(0);
+  std::vector<std::future<void>> futures;
+
+  // Tasks which submit further tasks place them in their own queue, from
+  // where other workers steal them.
+  for (int i = 0; i < 8; ++i)
+  {
+    futures.push_back(pool.submit([&]()
+    {
+      for (int j = 0; j < 100; ++j)
+      {
+        pool.submit([&]() { ++counter; });
+      }
+    }));
+  }
+  for (auto& future : futures)
+  {
+    future.get();
+  }
+  while (counter < 800)
+  {
+    std::this_thread::yield();
+  }
+  assert(counter == 800);
+}
+
+int
+main()
+{
+  test_mapped_file();
+  test_parse_files();
+  test_parse_batch();
+  test_work_stealing();
+}
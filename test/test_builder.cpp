@@ -0,0 +1,302 @@
+#include <cassert>
+#include <cstdlib>
+
+#include <plorth/parser/flat.hpp>
+#include <plorth/parser/iterative.hpp>
+#include <plorth/parser/parallel.hpp>
+#include <plorth/parser/push_parser.hpp>
+#include <plorth/parser/structural_index.hpp>
+#include <plorth/parser/token_stream.hpp>
+
+// Value of an imaginary interpreter, which the builder below constructs
+// directly from the source code without going through the AST tokens.
+struct value
+{
+  enum class kind
+  {
+    number,
+    string,
+    symbol,
+    word,
+    array,
+    object,
+    quote
+  };
+
+  enum kind kind;
+  double number;
+  std::u32string text;
+  std::vector<std::u32string> keys;
+  std::vector<value> elements;
+};
+
+class value_builder
+{
+public:
+  using token_type = value;
+  using array_type = value;
+  using object_type = value;
+  using quote_type = value;
+  using string_type = value;
+  using symbol_type = value;
+  using word_type = value;
+  using array_container_type = std::vector<value>;
+  using object_container_type = std::vector<std::pair<std::u32string, value>>;
+  using quote_container_type = std::vector<value>;
+
+  value make_array(
+    const plorth::parser::position&,
+    std::uint64_t,
+    array_container_type&& elements
+  ) const
+  {
+    return { value::kind::array, 0, U"", {}, std::move(elements) };
+  }
+
+  std::u32string make_key(
+    const plorth::parser::position&,
+    std::uint64_t,
+    const std::u32string_view& key
+  ) const
+  {
+    return std::u32string(key);
+  }
+
+  value make_object(
+    const plorth::parser::position&,
+    std::uint64_t,
+    object_container_type&& properties
+  ) const
+  {
+    value result = { value::kind::object, 0, U"", {}, {} };
+
+    for (auto& property : properties)
+    {
+      result.keys.push_back(std::move(property.first));
+      result.elements.push_back(std::move(property.second));
+    }
+
+    return result;
+  }
+
+  value make_quote(
+    const plorth::parser::position&,
+    std::uint64_t,
+    quote_container_type&& children
+  ) const
+  {
+    return { value::kind::quote, 0, U"", {}, std::move(children) };
+  }
+
+  value make_string(
+    const plorth::parser::position&,
+    std::uint64_t,
+    const std::u32string_view& text
+  ) const
+  {
+    return { value::kind::string, 0, std::u32string(text), {}, {} };
+  }
+
+  // Numeric symbols are converted into numbers right away.
+  value make_symbol(
+    const plorth::parser::position&,
+    std::uint64_t,
+    const std::u32string_view& id
+  ) const
+  {
+    const std::string narrow(std::cbegin(id), std::cend(id));
+    char* end;
+    const auto number = std::strtod(narrow.c_str(), &end);
+
+    if (!narrow.empty() && !*end)
+    {
+      return { value::kind::number, number, U"", {}, {} };
+    }
+
+    return { value::kind::symbol, 0, std::u32string(id), {}, {} };
+  }
+
+  value make_word(
+    const plorth::parser::position&,
+    std::uint64_t,
+    value&& symbol
+  ) const
+  {
+    return { value::kind::word, 0, std::move(symbol.text), {}, {} };
+  }
+};
+
+static_assert(plorth::parser::is_builder_v<value_builder>);
+static_assert(plorth::parser::is_builder_v<plorth::parser::ast::builder<>>);
+static_assert(plorth::parser::is_builder_v<plorth::parser::flat::builder>);
+static_assert(plorth::parser::is_builder_v<
+  plorth::parser::indexed_builder<value_builder>
+>);
+static_assert(!plorth::parser::is_builder_v<int>);
+static_assert(!plorth::parser::is_builder_v<std::u32string>);
+
+// Builder whose arrays cannot be stored where tokens are expected.
+struct unconvertible_builder : value_builder
+{
+  using array_type = std::u32string;
+
+  array_type make_array(
+    const plorth::parser::position&,
+    std::uint64_t,
+    array_container_type&&
+  ) const
+  {
+    return U"";
+  }
+};
+
+static_assert(!plorth::parser::is_builder_v<unconvertible_builder>);
+
+static void
+test_values_are_constructed_directly()
+{
+  const std::u32string source =
+    U"[1, 2.5, foo] {\"a\": -3, \"b\\n\": 'x'} (dup *) -> square";
+  auto current = std::cbegin(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    current,
+    std::cend(source),
+    position,
+    value_builder()
+  );
+
+  assert(!!result);
+  assert(result->size() == 4);
+
+  const auto& array = result->at(0);
+
+  assert(array.kind == value::kind::array);
+  assert(array.elements.size() == 3);
+  assert(array.elements[0].kind == value::kind::number);
+  assert(array.elements[0].number == 1);
+  assert(array.elements[1].number == 2.5);
+  assert(array.elements[2].kind == value::kind::symbol);
+  assert(array.elements[2].text == U"foo");
+
+  const auto& object = result->at(1);
+
+  assert(object.kind == value::kind::object);
+  assert(object.keys.size() == 2);
+  assert(object.keys[0] == U"a");
+  assert(object.keys[1] == U"b\n");
+  assert(object.elements[0].number == -3);
+  assert(object.elements[1].kind == value::kind::string);
+  assert(object.elements[1].text == U"x");
+
+  const auto& quote = result->at(2);
+
+  assert(quote.kind == value::kind::quote);
+  assert(quote.elements.size() == 2);
+  assert(quote.elements[1].text == U"*");
+
+  assert(result->at(3).kind == value::kind::word);
+  assert(result->at(3).text == U"square");
+}
+
+static void
+test_utf8_input()
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    u8"\"pää\" 42",
+    position,
+    value_builder()
+  );
+
+  assert(!!result);
+  assert(result->size() == 2);
+  assert(result->at(0).text == U"pää");
+  assert(result->at(1).number == 42);
+}
+
+static void
+test_errors()
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    "[1, 2",
+    position,
+    value_builder()
+  );
+
+  assert(!result);
+  assert(result.error().message == U"Unterminated array; Missing `]'.");
+}
+
+static void
+test_helpers()
+{
+  const std::u32string source = U"[1, 2] (foo) 3";
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  auto current = std::cbegin(source);
+  const auto iterative = plorth::parser::parse_iterative(
+    current,
+    std::cend(source),
+    position,
+    value_builder()
+  );
+
+  assert(!!iterative);
+  assert(iterative->size() == 3);
+  assert(iterative->at(0).elements[1].number == 2);
+
+  plorth::parser::thread_pool pool(2);
+
+  position = { U"<test>", 1, 1 };
+  current = std::cbegin(source);
+  const auto parallel = plorth::parser::parse_parallel(
+    current,
+    std::cend(source),
+    position,
+    pool,
+    value_builder(),
+    1
+  );
+
+  assert(!!parallel);
+  assert(parallel->size() == 3);
+  assert(parallel->at(2).number == 3);
+
+  plorth::parser::basic_push_parser<value_builder> push_parser(
+    { U"<test>", 1, 1 }
+  );
+
+  const auto first = push_parser.feed("[1, 2] (fo");
+  const auto second = push_parser.feed("o) 3");
+  const auto last = push_parser.finish();
+
+  assert(!!first && !!second && !!last);
+  assert(first->size() == 1);
+  assert(second->size() == 1);
+  assert(second->at(0).elements[0].text == U"foo");
+  assert(last->size() == 1);
+  assert(last->at(0).number == 3);
+
+  plorth::parser::basic_token_stream<
+    std::u32string::const_iterator,
+    value_builder
+  > stream(std::cbegin(source), std::cend(source), { U"<test>", 1, 1 });
+  std::size_t count = 0;
+
+  for (const auto& result : stream)
+  {
+    assert(!!result);
+    ++count;
+  }
+  assert(count == 3);
+}
+
+int
+main()
+{
+  test_values_are_constructed_directly();
+  test_utf8_input();
+  test_errors();
+  test_helpers();
+}
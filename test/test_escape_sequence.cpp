@@ -86,6 +86,19 @@ test_invalid_hex_escape()
   assert(!parse(U"\\ud805"));
 }
 
+static void
+test_decode_escape_sequences()
+{
+  using plorth::parser::decode_escape_sequences;
+
+  assert(decode_escape_sequences(U"") == U"");
+  assert(decode_escape_sequences(U"foo") == U"foo");
+  assert(decode_escape_sequences(U"\\n") == U"\n");
+  assert(
+    decode_escape_sequences(U"a\\tb\\u00e4\\\"\\\\c") == U"a\tb\u00e4\"\\c"
+  );
+}
+
 int
 main()
 {
@@ -98,4 +111,5 @@ main()
   test_unterminated_hex_escape();
   test_non_hex_hex_escape();
   test_invalid_hex_escape();
+  test_decode_escape_sequences();
 }
@@ -0,0 +1,278 @@
+#include <cassert>
+
+#include <plorth/parser/events.hpp>
+
+using plorth::parser::ast::array;
+using plorth::parser::ast::object;
+using plorth::parser::ast::quote;
+using plorth::parser::ast::string;
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+using plorth::parser::ast::word;
+
+// Records received events as text, so that they can be compared against
+// the AST returned by parse().
+struct recorder : public plorth::parser::event_handler
+{
+  std::u32string log;
+
+  void on_array_begin(const plorth::parser::position& position)
+  {
+    log += U"[" + offset(position);
+  }
+
+  void on_array_end(const plorth::parser::position&, std::uint64_t end)
+  {
+    log += U"]" + offset(end);
+  }
+
+  void on_object_begin(const plorth::parser::position& position)
+  {
+    log += U"{" + offset(position);
+  }
+
+  void on_object_key(
+    const plorth::parser::position& position,
+    std::uint64_t,
+    const std::u32string_view& key
+  )
+  {
+    log += U"k" + offset(position) + std::u32string(key);
+  }
+
+  void on_object_end(const plorth::parser::position&, std::uint64_t end)
+  {
+    log += U"}" + offset(end);
+  }
+
+  void on_quote_begin(const plorth::parser::position& position)
+  {
+    log += U"(" + offset(position);
+  }
+
+  void on_quote_end(const plorth::parser::position&, std::uint64_t end)
+  {
+    log += U")" + offset(end);
+  }
+
+  void on_string(
+    const plorth::parser::position& position,
+    std::uint64_t end,
+    const std::u32string_view& value
+  )
+  {
+    log += U"\"" + offset(position) + std::u32string(value) + offset(end);
+  }
+
+  void on_symbol(
+    const plorth::parser::position& position,
+    std::uint64_t end,
+    const std::u32string_view& id
+  )
+  {
+    log += U"s" + offset(position) + std::u32string(id) + offset(end);
+  }
+
+  void on_word(
+    const plorth::parser::position& position,
+    std::uint64_t end,
+    const plorth::parser::position& symbol_position,
+    const std::u32string_view& id
+  )
+  {
+    log += U":" + offset(position) + offset(symbol_position);
+    log += std::u32string(id) + offset(end);
+  }
+
+  static std::u32string offset(const plorth::parser::position& position)
+  {
+    return offset(position.offset);
+  }
+
+  static std::u32string offset(std::uint64_t value)
+  {
+    const auto text = std::to_string(value);
+
+    return U"@" + std::u32string(std::cbegin(text), std::cend(text)) + U" ";
+  }
+};
+
+static void
+record(const std::shared_ptr<token>& token, recorder& r)
+{
+  switch (token->type())
+  {
+    case token::type::array:
+      r.on_array_begin(token->position());
+      for (const auto& element : std::static_pointer_cast<array>(token)
+          ->elements())
+      {
+        record(element, r);
+      }
+      r.on_array_end(token->position(), token->span().end);
+      break;
+
+    case token::type::object:
+      r.on_object_begin(token->position());
+      for (const auto& property : std::static_pointer_cast<object>(token)
+          ->properties())
+      {
+        r.log += U"k" + std::u32string(property.first);
+        record(property.second, r);
+      }
+      r.on_object_end(token->position(), token->span().end);
+      break;
+
+    case token::type::quote:
+      r.on_quote_begin(token->position());
+      for (const auto& child : std::static_pointer_cast<quote>(token)
+          ->children())
+      {
+        record(child, r);
+      }
+      r.on_quote_end(token->position(), token->span().end);
+      break;
+
+    case token::type::string:
+      r.on_string(
+        token->position(),
+        token->span().end,
+        std::static_pointer_cast<string>(token)->value()
+      );
+      break;
+
+    case token::type::symbol:
+      r.on_symbol(
+        token->position(),
+        token->span().end,
+        std::static_pointer_cast<symbol>(token)->id()
+      );
+      break;
+
+    case token::type::word:
+      {
+        const auto& s = std::static_pointer_cast<word>(token)->symbol();
+
+        r.on_word(
+          token->position(),
+          token->span().end,
+          s->position(),
+          s->id()
+        );
+      }
+      break;
+  }
+}
+
+// Removes key positions from the log, since object properties of the AST do
+// not retain them.
+static std::u32string
+strip_key_positions(const std::u32string& log)
+{
+  std::u32string result;
+
+  for (std::size_t i = 0; i < log.length(); ++i)
+  {
+    result.append(1, log[i]);
+    if (log[i] == U'k' && i + 1 < log.length() && log[i + 1] == U'@')
+    {
+      i = log.find(U' ', i);
+    }
+  }
+
+  return result;
+}
+
+static void
+test_events_match_ast()
+{
+  const std::string source =
+    u8"# comment\n"
+    u8"(dup 1 + \"str)ing\" 'esc\\'aped') -> my-word\n"
+    u8"[1, 2, {\"key\": 'value', \"k2\": :colon, \"nested\": [a, (b c)]}]\n"
+    u8"äö \"pää\\n\" foo#bar {} [] () [1,]";
+  const auto decoded = plorth::parser::utf8::decode(source);
+  auto begin = std::cbegin(decoded);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    begin,
+    std::cend(decoded),
+    position
+  );
+  recorder expected;
+
+  assert(!!result);
+  for (const auto& token : *result)
+  {
+    record(token, expected);
+  }
+
+  recorder utf32;
+  auto current = std::cbegin(decoded);
+  plorth::parser::position position1 = { U"<test>", 1, 1 };
+
+  assert(!plorth::parser::parse_events(
+    current,
+    std::cend(decoded),
+    position1,
+    utf32
+  ));
+  assert(strip_key_positions(utf32.log) == expected.log);
+  assert(position1.offset == position.offset);
+  assert(position1.line == position.line);
+
+  recorder utf8;
+  plorth::parser::position position2 = { U"<test>", 1, 1 };
+
+  assert(!plorth::parser::parse_events(source, position2, utf8));
+  assert(position2.line == position.line);
+  assert(position2.column == position.column);
+}
+
+static void
+test_errors_match_parse()
+{
+  const char* inputs[] =
+  {
+    "[",
+    "[1 2]",
+    "[1,",
+    "[,]",
+    "{",
+    "{\"a\"",
+    "{\"a\" 1}",
+    "{a: 1}",
+    "{\"a\": 1 \"b\": 2}",
+    "{\"a\":",
+    "(foo",
+    "\"foo",
+    "'\\x'",
+    "]",
+    "foo ]",
+    "->",
+    "-> ]",
+    "foo ",
+    "[(1, {\"a\": [1, 2,]}) ",
+  };
+
+  for (const auto input : inputs)
+  {
+    plorth::parser::position position1 = { U"<test>", 1, 1 };
+    plorth::parser::position position2 = { U"<test>", 1, 1 };
+    plorth::parser::event_handler handler;
+    const auto expected = plorth::parser::parse(input, position1);
+    const auto error = plorth::parser::parse_events(input, position2, handler);
+
+    assert(!expected);
+    assert(!!error);
+    assert(error->message == expected.error().message);
+    assert(error->position.offset == expected.error().position.offset);
+  }
+}
+
+int
+main()
+{
+  test_events_match_ast();
+  test_errors_match_parse();
+}
@@ -0,0 +1,143 @@
+#include <cassert>
+
+#include <limits>
+
+#include <plorth/parser/flat.hpp>
+
+using plorth::parser::ast::token;
+
+static auto
+parse(const std::u32string& source)
+{
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  return plorth::parser::flat::parse(begin, end, position);
+}
+
+static void
+test_parse_error()
+{
+  const auto result = parse(U"[foo");
+
+  assert(!result);
+}
+
+static void
+test_parse()
+{
+  const std::u32string source(U"[foo, \"bar\"]\n(-> baz) {\"a\": b}");
+  const plorth::parser::u32line_index lines(source);
+  const auto result = parse(source);
+
+  assert(!!result);
+
+  const auto& tree = *result;
+  const auto roots = tree.roots();
+
+  assert(roots.size() == 3);
+  assert(tree.type(roots[0]) == token::type::array);
+  assert(tree.type(roots[1]) == token::type::quote);
+  assert(tree.type(roots[2]) == token::type::object);
+
+  const auto elements = tree.children(roots[0]);
+
+  assert(elements.size() == 2);
+  assert(tree.type(elements[0]) == token::type::symbol);
+  assert(tree.text(elements[0]) == U"foo");
+  assert(tree.type(elements[1]) == token::type::string);
+  assert(tree.text(elements[1]) == U"bar");
+  assert(tree.children(elements[1]).empty());
+
+  const auto children = tree.children(roots[1]);
+
+  assert(children.size() == 1);
+  assert(tree.type(children[0]) == token::type::word);
+  assert(tree.text(tree.children(children[0])[0]) == U"baz");
+  assert(tree.position(roots[1], lines).line == 2);
+  assert(tree.position(roots[1], lines).column == 1);
+  assert(tree.position(roots[1], lines).file == U"<test>");
+  assert(tree.span(roots[1]).begin == 13);
+  assert(tree.span(roots[1]).end == 21);
+
+  const auto properties = tree.children(roots[2]);
+
+  assert(properties.size() == 2);
+  assert(tree.type(properties[0]) == token::type::string);
+  assert(tree.text(properties[0]) == U"a");
+  assert(tree.text(properties[1]) == U"b");
+
+  // Nodes are stored in post-order.
+  for (std::size_t i = 0; i < tree.size(); ++i)
+  {
+    for (const auto child : tree.children(i))
+    {
+      assert(child < i);
+    }
+  }
+}
+
+static void
+test_round_trip()
+{
+  const std::u32string source(U"[foo, \"bar\"] (-> baz) {\"a\": [b]}");
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(begin, end, position);
+
+  assert(!!result);
+
+  const auto tree = plorth::parser::flat::from_ast(*result);
+  const auto tokens = plorth::parser::flat::to_ast(
+    tree,
+    plorth::parser::u32line_index(source)
+  );
+
+  assert(tree.size() == parse(source)->size());
+  assert(tokens.size() == 3);
+  assert(tokens[0]->type() == token::type::array);
+  assert(tokens[1]->type() == token::type::quote);
+  assert(tokens[2]->type() == token::type::object);
+
+  const auto object = std::static_pointer_cast<plorth::parser::ast::object>(
+    tokens[2]
+  );
+
+  assert(object->properties().size() == 1);
+  assert(object->properties()[0].first == U"a");
+  assert(object->properties()[0].second->type() == token::type::array);
+
+  const auto quote = std::static_pointer_cast<plorth::parser::ast::quote>(
+    tokens[1]
+  );
+  const auto word = std::static_pointer_cast<plorth::parser::ast::word>(
+    quote->children()[0]
+  );
+
+  assert(word->symbol()->id() == U"baz");
+  assert(word->position().column == 15);
+}
+
+static void
+test_overflow()
+{
+  const std::u32string source(U"[foo bar]");
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  position.offset = std::numeric_limits<std::uint32_t>::max() - 4;
+
+  assert(!plorth::parser::flat::parse(begin, end, position));
+}
+
+int
+main()
+{
+  test_parse_error();
+  test_parse();
+  test_round_trip();
+  test_overflow();
+}
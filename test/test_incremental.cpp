@@ -0,0 +1,185 @@
+#include <cassert>
+
+#include <plorth/parser/incremental.hpp>
+
+#include "./compare.hpp"
+
+using plorth::parser::ast::array;
+using plorth::parser::ast::object;
+using plorth::parser::ast::quote;
+using plorth::parser::ast::symbol;
+
+static const std::u32string sample =
+  U"# comment\n"
+  U"(dup [1, 2,\n  {\"a\": (x y), \"b\": 'z'}] swap) -> foo\n"
+  U"bar [(baz\n  qux)] \"str\\n\" # end\n"
+  U"last";
+
+static const plorth::parser::position initial_position = {
+  U"<test>",
+  3,
+  5,
+  7
+};
+
+static plorth::parser::parse_result
+parse(const std::u32string& source)
+{
+  auto current = std::cbegin(source);
+  const auto end = std::cend(source);
+  auto position = initial_position;
+
+  return plorth::parser::parse(current, end, position);
+}
+
+// Applies the edit to the sample and checks that reparsing gives the same
+// result as parsing the edited source code from scratch.
+static void
+check(std::size_t offset, std::size_t removed, const std::u32string& text)
+{
+  const auto old_result = parse(sample);
+  auto source = sample;
+
+  assert(!!old_result);
+  source.replace(offset, removed, text);
+
+  const auto expected = parse(source);
+  const auto result = plorth::parser::reparse(
+    *old_result,
+    source,
+    { offset, removed, text.length() },
+    initial_position
+  );
+
+  assert(!!result == !!expected);
+  if (!expected)
+  {
+    assert(result.error().message == expected.error().message);
+    assert(result.error().position.line == expected.error().position.line);
+    assert(
+      result.error().position.column == expected.error().position.column
+    );
+    return;
+  }
+  assert(result->size() == expected->size());
+  for (std::size_t i = 0; i < result->size(); ++i)
+  {
+    compare(result->at(i), expected->at(i));
+  }
+}
+
+static void
+test_every_edit()
+{
+  static const char32_t* insertions[] =
+  {
+    U"x",
+    U" ",
+    U"\n",
+    U"\n\n ",
+    U"[",
+    U"]",
+    U"(",
+    U")",
+    U"\"",
+    U"#",
+    U",",
+    U"->",
+  };
+
+  for (std::size_t offset = 0; offset <= sample.length(); ++offset)
+  {
+    for (const auto insertion : insertions)
+    {
+      check(offset, 0, insertion);
+    }
+    for (std::size_t removed = 1; removed <= 3; ++removed)
+    {
+      if (offset + removed <= sample.length())
+      {
+        check(offset, removed, U"");
+        check(offset, removed, U"y\nz");
+      }
+    }
+  }
+}
+
+static void
+test_tokens_are_reused()
+{
+  const auto old_result = parse(sample);
+  const auto old_tokens = *old_result;
+  auto source = sample;
+  // Inside the quote nested in the object.
+  const auto offset = sample.find(U"x y");
+
+  source.insert(offset, U"w ");
+
+  const auto result = plorth::parser::reparse(
+    old_tokens,
+    source,
+    { offset, 0, 2 },
+    initial_position
+  );
+
+  assert(!!result);
+  assert(result->size() == old_tokens.size());
+
+  const auto old_quote = std::static_pointer_cast<quote>(old_tokens[0]);
+  const auto new_quote = std::static_pointer_cast<quote>(result->at(0));
+  const auto old_array = std::static_pointer_cast<array>(
+    old_quote->children()[1]
+  );
+  const auto new_array = std::static_pointer_cast<array>(
+    new_quote->children()[1]
+  );
+
+  // Containers enclosing the edit are replaced.
+  assert(new_quote != old_quote);
+  assert(new_array != old_array);
+  assert(new_array->span().end == old_array->span().end + 2);
+
+  // Tokens before and after the edit are reused.
+  assert(new_quote->children()[0] == old_quote->children()[0]);
+  assert(new_array->elements()[0] == old_array->elements()[0]);
+  assert(new_quote->children()[2] == old_quote->children()[2]);
+  assert(result->at(1) == old_tokens[1]);
+  assert(result->at(2) == old_tokens[2]);
+  assert(result->at(5) == old_tokens[5]);
+
+  // Which have been moved to their new positions.
+  const auto b = std::static_pointer_cast<object>(new_array->elements()[2])
+    ->properties()[1].second;
+
+  assert(source.substr(b->position().offset - 7, 3) == U"'z'");
+  assert(b->position().line == 5);
+  assert(b->position().column == 23);
+  assert(result->at(1)->position().line == 5);
+  assert(result->at(1)->position().column == 35);
+  assert(result->at(5)->position().line == 8);
+  assert(result->at(5)->position().column == 1);
+}
+
+static void
+test_empty_source()
+{
+  const std::u32string source = U"foo";
+  const auto result = plorth::parser::reparse(
+    {},
+    source,
+    { 0, 0, 3 },
+    initial_position
+  );
+
+  assert(!!result);
+  assert(result->size() == 1);
+  assert(std::static_pointer_cast<symbol>(result->at(0))->id() == U"foo");
+}
+
+int
+main()
+{
+  test_every_edit();
+  test_tokens_are_reused();
+  test_empty_source();
+}
@@ -0,0 +1,167 @@
+#include <cassert>
+
+#include <plorth/parser/flat.hpp>
+#include <plorth/parser/iterative.hpp>
+
+#include "./compare.hpp"
+
+static void
+test_same_result_as_parse()
+{
+  const std::string source =
+    u8"# comment\n"
+    u8"(dup 1 + \"str)ing\" 'esc\\'aped') -> my-word\n"
+    u8"[1, 2, {\"key\": 'value', \"k\\n2\": :colon, \"nested\": [a, (b c)]}]\n"
+    u8"äö \"pää\\n\" foo#bar {} [] () [1,]";
+  const auto decoded = plorth::parser::utf8::decode(source);
+  plorth::parser::position position1 = { U"<test>", 1, 1 };
+  plorth::parser::position position2 = { U"<test>", 1, 1 };
+  const auto expected = plorth::parser::parse(source, position1);
+  const auto result = plorth::parser::parse_iterative(source, position2);
+
+  assert(!!expected);
+  assert(!!result);
+  assert(expected->size() == result->size());
+  for (std::size_t i = 0; i < result->size(); ++i)
+  {
+    compare(expected->at(i), result->at(i));
+  }
+  assert(position1.offset == position2.offset);
+
+  auto current1 = std::cbegin(decoded);
+  auto current2 = std::cbegin(decoded);
+  plorth::parser::position position3 = { U"<test>", 1, 1 };
+  plorth::parser::position position4 = { U"<test>", 1, 1 };
+  plorth::parser::ast::builder<> builder;
+
+  builder.set_source_views(true);
+
+  const auto expected32 = plorth::parser::parse(
+    current1,
+    std::cend(decoded),
+    position3,
+    builder
+  );
+  const auto result32 = plorth::parser::parse_iterative(
+    current2,
+    std::cend(decoded),
+    position4,
+    builder
+  );
+
+  assert(!!expected32);
+  assert(!!result32);
+  assert(expected32->size() == result32->size());
+  for (std::size_t i = 0; i < result32->size(); ++i)
+  {
+    compare(expected32->at(i), result32->at(i));
+  }
+}
+
+static void
+test_errors()
+{
+  const char* inputs[] =
+  {
+    "[1 2]",
+    "{\"a\": 1 \"b\": 2}",
+    "(foo",
+    "'\\x'",
+    "-> ]",
+    "foo ",
+  };
+
+  for (const auto input : inputs)
+  {
+    plorth::parser::position position1 = { U"<test>", 1, 1 };
+    plorth::parser::position position2 = { U"<test>", 1, 1 };
+    const auto expected = plorth::parser::parse(input, position1);
+    const auto result = plorth::parser::parse_iterative(input, position2);
+
+    assert(!expected);
+    assert(!result);
+    assert(result.error().message == expected.error().message);
+    assert(
+      result.error().position.offset == expected.error().position.offset
+    );
+  }
+}
+
+static void
+test_deep_nesting()
+{
+  const std::size_t depth = 1000000;
+  std::string source(depth, '[');
+
+  source.append(depth, ']');
+
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  plorth::parser::flat::tree tree;
+  const auto result = plorth::parser::parse_iterative(
+    source,
+    position,
+    plorth::parser::flat::builder(tree)
+  );
+
+  assert(!!result);
+  assert(result->size() == 1);
+  assert(tree.size() == depth);
+}
+
+static void
+test_deep_nesting_ast()
+{
+  const std::size_t depth = 1000000;
+  std::string source;
+
+  for (std::size_t i = 0; i < depth; ++i)
+  {
+    source += i % 3 == 0 ? "[" : i % 3 == 1 ? "(" : "{\"k\": ";
+  }
+  for (std::size_t i = depth; i > 0; --i)
+  {
+    source += (i - 1) % 3 == 0 ? "]" : (i - 1) % 3 == 1 ? ")" : "}";
+  }
+
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  auto result = plorth::parser::parse_iterative(source, position);
+
+  assert(!!result);
+  assert(result->size() == 1);
+  // Destroying the tree must not recurse once per nesting level.
+  result = plorth::parser::parse_result::ok({});
+}
+
+static void
+test_max_depth()
+{
+  plorth::parser::position position1 = { U"<test>", 1, 1 };
+  plorth::parser::position position2 = { U"<test>", 1, 1 };
+  const auto result1 = plorth::parser::parse_iterative(
+    "[({\"a\": [1]})]",
+    position1,
+    plorth::parser::ast::builder<>(),
+    4
+  );
+  const auto result2 = plorth::parser::parse_iterative(
+    "[({\"a\": [[1]]})]",
+    position2,
+    plorth::parser::ast::builder<>(),
+    4
+  );
+
+  assert(!!result1);
+  assert(!result2);
+  assert(result2.error().message == U"Maximum nesting depth exceeded.");
+  assert(result2.error().position.offset == 9);
+}
+
+int
+main()
+{
+  test_same_result_as_parse();
+  test_errors();
+  test_deep_nesting();
+  test_deep_nesting_ast();
+  test_max_depth();
+}
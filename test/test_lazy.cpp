@@ -0,0 +1,233 @@
+#include <cassert>
+#include <thread>
+
+#include <plorth/parser/lazy.hpp>
+
+#include "./compare.hpp"
+
+using plorth::parser::ast::quote;
+using plorth::parser::ast::string;
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+
+static_assert(
+  plorth::parser::is_builder_v<plorth::parser::ast::lazy_builder<>>
+);
+
+template<class BuilderT = plorth::parser::ast::builder<>>
+static plorth::parser::basic_parse_result<BuilderT>
+parse(const std::u32string& source)
+{
+  auto current = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  return plorth::parser::parse(current, end, position, BuilderT());
+}
+
+static void
+test_same_as_eager()
+{
+  // Parentheses inside string literals, comments and symbols must not be
+  // mistaken for the end of the quote.
+  const std::u32string source =
+    U"(dup \")\" 'a\\')' # )\n"
+    U"  (nested [1, {\"(\": \")\"}] (deeper)) a\"b#c)\n"
+    U" -> foo\n"
+    U"[(x), 'y'] () (\n)";
+  const auto eager = parse(source);
+  const auto lazy = parse<plorth::parser::ast::lazy_builder<>>(source);
+
+  assert(!!eager);
+  assert(!!lazy);
+  assert(lazy->size() == eager->size());
+  for (std::size_t i = 0; i < lazy->size(); ++i)
+  {
+    compare(lazy->at(i), eager->at(i));
+  }
+}
+
+static void
+test_nested_quotes()
+{
+  const std::u32string source =
+    U"(a (b\n  (c \"(\" # (\n d)\n (e)) f\n) (g (h) \"\\n)\") ((((i))))";
+  const auto eager = parse(source);
+  const auto lazy = parse<plorth::parser::ast::lazy_builder<>>(source);
+
+  assert(!!eager);
+  assert(!!lazy);
+  assert(lazy->size() == eager->size());
+  for (std::size_t i = 0; i < lazy->size(); ++i)
+  {
+    compare(lazy->at(i), eager->at(i));
+  }
+}
+
+static void
+test_symbol_table()
+{
+  const std::u32string source = U"(a (a b))";
+  plorth::parser::symbol_table thread_safe(true);
+  plorth::parser::symbol_table not_thread_safe;
+
+  for (const auto table : { &thread_safe, &not_thread_safe })
+  {
+    auto current = std::cbegin(source);
+    plorth::parser::position position = { U"<test>", 1, 1 };
+    const auto result = plorth::parser::parse(
+      current,
+      std::cend(source),
+      position,
+      plorth::parser::ast::lazy_builder<>(*table)
+    );
+
+    assert(!!result);
+
+    const auto outer = std::static_pointer_cast<quote>(result->at(0));
+    const auto inner = std::static_pointer_cast<quote>(outer->children()[1]);
+
+    // Quotes are parsed eagerly unless the symbol table is thread safe.
+    assert(outer->is_lazy() == table->thread_safe());
+    assert(inner->is_lazy() == table->thread_safe());
+    assert(
+      std::static_pointer_cast<symbol>(outer->children()[0])->id().id()
+      == std::static_pointer_cast<symbol>(inner->children()[0])->id().id()
+    );
+    assert(table->size() == 2);
+  }
+}
+
+static void
+test_children_are_parsed_on_demand()
+{
+  const std::u32string source = U"(a (b c) d)";
+  const auto result = parse<plorth::parser::ast::lazy_builder<>>(source);
+
+  assert(!!result);
+
+  const auto outer = std::static_pointer_cast<quote>(result->at(0));
+
+  assert(outer->is_lazy());
+  assert(outer->span().end == source.length());
+  assert(outer->children().size() == 3);
+
+  const auto inner = std::static_pointer_cast<quote>(outer->children()[1]);
+
+  assert(inner->is_lazy());
+  assert(inner->position().column == 4);
+  assert(inner->children().size() == 2);
+  assert(
+    std::static_pointer_cast<symbol>(inner->children()[1])->id() == U"c"
+  );
+}
+
+static void
+test_errors_are_reported_when_parsing()
+{
+  static const char32_t* sources[] =
+  {
+    U"(",
+    U"(a",
+    U"(a (b)",
+    U"(\"a)",
+    U"(# a)",
+    U"([1 2])",
+    U"({\"a\" 1})",
+    U"(-> )",
+    U"(a ]",
+  };
+
+  for (const auto source : sources)
+  {
+    const auto eager = parse(source);
+    const auto lazy = parse<plorth::parser::ast::lazy_builder<>>(source);
+
+    assert(!eager);
+    assert(!lazy);
+    assert(lazy.error().message == eager.error().message);
+    assert(lazy.error().position.line == eager.error().position.line);
+    assert(lazy.error().position.column == eager.error().position.column);
+  }
+}
+
+static void
+test_utf8_source()
+{
+  const std::string source = u8"(ä \"ö)\" (ö\n(ä))) x";
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    source,
+    position,
+    plorth::parser::ast::lazy_builder<>()
+  );
+
+  assert(!!result);
+  assert(result->size() == 2);
+
+  const auto q = std::static_pointer_cast<quote>(result->at(0));
+
+  assert(q->is_lazy());
+  assert(q->children().size() == 3);
+  assert(
+    std::static_pointer_cast<string>(q->children()[1])->value() == U"ö)"
+  );
+
+  const auto inner = std::static_pointer_cast<quote>(q->children()[2]);
+
+  assert(inner->is_lazy());
+  assert(inner->span().end == 19);
+  assert(inner->children()[1]->position().line == 2);
+  assert(inner->children()[1]->position().column == 1);
+  assert(result->at(1)->position().line == 2);
+  assert(result->at(1)->position().column == 7);
+}
+
+static void
+test_concurrent_access()
+{
+  std::u32string source = U"(";
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    source += U"a [b, c] ";
+  }
+  source += U")";
+
+  const auto result = parse<plorth::parser::ast::lazy_builder<>>(source);
+
+  assert(!!result);
+
+  const auto q = std::static_pointer_cast<quote>(result->at(0));
+  const token* first[4];
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.emplace_back([&q, &first, i]()
+    {
+      first[i] = q->children().at(0).get();
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  for (int i = 1; i < 4; ++i)
+  {
+    assert(first[i] == first[0]);
+  }
+  assert(q->children().size() == 2000);
+}
+
+int
+main()
+{
+  test_same_as_eager();
+  test_nested_quotes();
+  test_symbol_table();
+  test_children_are_parsed_on_demand();
+  test_errors_are_reported_when_parsing();
+  test_utf8_source();
+  test_concurrent_access();
+}
@@ -0,0 +1,132 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/line_index.hpp>
+
+using plorth::parser::ast::array;
+using plorth::parser::ast::word;
+
+static void
+test_line_count()
+{
+  assert(plorth::parser::line_index("").line_count() == 1);
+  assert(plorth::parser::line_index("foo").line_count() == 1);
+  assert(plorth::parser::line_index("foo\nbar").line_count() == 2);
+  assert(plorth::parser::line_index("foo\nbar\n").line_count() == 3);
+}
+
+static void
+test_locate()
+{
+  const plorth::parser::line_index index("foo\n\xc3\xa4\xc3\xa4 bar\n\nbaz");
+
+  assert(index.locate(0).line == 1);
+  assert(index.locate(0).column == 1);
+  assert(index.locate(3).line == 1);
+  assert(index.locate(3).column == 4);
+  assert(index.locate(4).line == 2);
+  assert(index.locate(4).column == 1);
+  // Multibyte characters count as single column.
+  assert(index.locate(9).line == 2);
+  assert(index.locate(9).column == 4);
+  assert(index.locate(13).line == 3);
+  assert(index.locate(14).line == 4);
+  assert(index.locate(14, U"foo.plorth").file == U"foo.plorth");
+  assert(index.locate(14).offset == 14);
+}
+
+static void
+test_spans()
+{
+  const std::u32string source(U"[foo, \"bar\"]\n  (-> baz)");
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(begin, end, position);
+
+  assert(!!result);
+  assert(position.offset == source.length());
+
+  const auto a = std::static_pointer_cast<array>(result->at(0));
+
+  assert(a->span().begin == 0);
+  assert(a->span().end == 12);
+  assert(a->elements()[0]->span().begin == 1);
+  assert(a->elements()[0]->span().end == 4);
+  assert(a->elements()[1]->span().begin == 6);
+  assert(a->elements()[1]->span().end == 11);
+  assert(result->at(1)->span().begin == 15);
+  assert(result->at(1)->span().end == 23);
+
+  const auto quote = std::static_pointer_cast<plorth::parser::ast::quote>(
+    result->at(1)
+  );
+  const auto w = std::static_pointer_cast<word>(quote->children()[0]);
+
+  assert(w->span().begin == 16);
+  assert(w->span().end == 22);
+  assert(w->symbol()->span().begin == 19);
+
+  const plorth::parser::u32line_index index(source);
+  const auto located = index.locate(w->span().begin);
+
+  assert(located.line == w->position().line);
+  assert(located.column == w->position().column);
+}
+
+static void
+test_utf8_spans()
+{
+  const std::string source("'\xc3\xa4' foo");
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(source, position);
+
+  assert(!!result);
+  assert(result->at(0)->span().begin == 0);
+  assert(result->at(0)->span().end == 4);
+  assert(result->at(1)->span().begin == 5);
+  assert(result->at(1)->position().column == 5);
+
+  const plorth::parser::line_index index(source);
+
+  assert(index.locate(result->at(1)->span().begin).column == 5);
+}
+
+static void
+test_malformed_utf8()
+{
+  const std::string sources[] = {
+    "\x80\x80 foo",
+    "\xc3 foo",
+    "\xc0\x80 foo",
+    "\xe2\x82 foo",
+    "\xed\xa0\x80 foo",
+    "'\xf0\x9f\x98\xc3\xa4' foo",
+  };
+
+  for (const auto& source : sources)
+  {
+    plorth::parser::position position = { U"<test>", 1, 1 };
+    const auto result = plorth::parser::parse(source, position);
+
+    assert(!!result);
+
+    const auto& token = result->back();
+    const auto located = plorth::parser::line_index(source).locate(
+      token->span().begin
+    );
+
+    assert(located.line == token->position().line);
+    assert(located.column == token->position().column);
+  }
+}
+
+int
+main()
+{
+  test_line_count();
+  test_locate();
+  test_spans();
+  test_utf8_spans();
+  test_malformed_utf8();
+}
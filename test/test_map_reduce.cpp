@@ -0,0 +1,224 @@
+#include <cassert>
+#include <stdexcept>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/map_reduce.hpp>
+#include <plorth/parser/traversal.hpp>
+
+using plorth::parser::ast::array;
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+
+static plorth::parser::parse_result
+parse(const std::string& source)
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  return plorth::parser::parse(source, position);
+}
+
+static std::size_t
+count_tokens(const std::shared_ptr<token>& subtree)
+{
+  plorth::parser::ast::pre_order_traversal traversal(subtree);
+  std::size_t count = 0;
+
+  for (auto it = std::begin(traversal); it != std::end(traversal); ++it)
+  {
+    ++count;
+  }
+
+  return count;
+}
+
+static std::size_t
+add(std::size_t a, std::size_t b)
+{
+  return a + b;
+}
+
+static void
+test_count_tokens()
+{
+  std::string source;
+
+  for (int i = 0; i < 200; ++i)
+  {
+    source += "a [b, (c d), {\"k\": e}] (f) -> g" + std::to_string(i) + " ";
+  }
+  source += "h";
+
+  const auto result = parse(source);
+  plorth::parser::thread_pool pool(3);
+
+  assert(!!result);
+
+  std::size_t expected = 0;
+
+  for (const auto& subtree : *result)
+  {
+    expected += count_tokens(subtree);
+  }
+
+  for (std::size_t chunks = 0; chunks < 10; ++chunks)
+  {
+    assert(plorth::parser::ast::parallel_map_reduce<std::size_t>(
+      *result,
+      pool,
+      0,
+      count_tokens,
+      add,
+      chunks
+    ) == expected);
+  }
+}
+
+static void
+test_elements_of_array()
+{
+  std::string source = "[";
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    source += "[x, y], ";
+  }
+  source += "z]";
+
+  const auto result = parse(source);
+  plorth::parser::thread_pool pool(2);
+
+  assert(!!result);
+
+  const auto& elements = std::static_pointer_cast<array>(
+    result->at(0)
+  )->elements();
+
+  assert(plorth::parser::ast::parallel_map_reduce<std::size_t>(
+    elements,
+    pool,
+    0,
+    count_tokens,
+    add
+  ) == 3001);
+}
+
+// Concatenation is not commutative, so the results must be combined in the
+// order of the subtrees.
+static void
+test_order_is_preserved()
+{
+  std::string source;
+  std::u32string expected;
+
+  for (int i = 0; i < 26; ++i)
+  {
+    source += static_cast<char>('a' + i);
+    source += ' ';
+    expected += static_cast<char32_t>(U'a' + i);
+  }
+  source.pop_back();
+
+  const auto result = parse(source);
+  plorth::parser::thread_pool pool(4);
+
+  assert(!!result);
+  assert(plorth::parser::ast::parallel_map_reduce<std::u32string>(
+    *result,
+    pool,
+    U"",
+    [](const std::shared_ptr<token>& subtree)
+    {
+      return std::u32string(std::static_pointer_cast<symbol>(subtree)->id());
+    },
+    [](std::u32string a, const std::u32string& b)
+    {
+      return a + b;
+    },
+    7
+  ) == expected);
+}
+
+static void
+test_empty()
+{
+  plorth::parser::thread_pool pool(2);
+
+  assert(plorth::parser::ast::parallel_map_reduce<std::size_t>(
+    {},
+    pool,
+    42,
+    count_tokens,
+    add
+  ) == 42);
+}
+
+static void
+test_exception_is_passed_on()
+{
+  const auto result = parse("a b c d");
+  plorth::parser::thread_pool pool(2);
+  bool thrown = false;
+
+  assert(!!result);
+
+  try
+  {
+    plorth::parser::ast::parallel_map_reduce<std::size_t>(
+      *result,
+      pool,
+      0,
+      [](const std::shared_ptr<token>& subtree) -> std::size_t
+      {
+        if (std::static_pointer_cast<symbol>(subtree)->id() == U"c")
+        {
+          throw std::runtime_error("c");
+        }
+
+        return 1;
+      },
+      add
+    );
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+static void
+test_split_subtrees()
+{
+  const auto result = parse("a [b, c, d, e, f, g, h] i j k l m n");
+
+  assert(!!result);
+
+  for (std::size_t max_chunks = 0; max_chunks < 16; ++max_chunks)
+  {
+    const auto chunks = plorth::parser::ast::internal::split_subtrees(
+      *result,
+      max_chunks
+    );
+    std::size_t begin = 0;
+
+    assert(chunks.size() <= std::max<std::size_t>(max_chunks, 1));
+    for (const auto& chunk : chunks)
+    {
+      assert(chunk.begin == begin);
+      assert(chunk.end > chunk.begin);
+      begin = chunk.end;
+    }
+    assert(begin == result->size());
+  }
+}
+
+int
+main()
+{
+  test_count_tokens();
+  test_elements_of_array();
+  test_order_is_preserved();
+  test_empty();
+  test_exception_is_passed_on();
+  test_split_subtrees();
+}
@@ -0,0 +1,76 @@
+#define PLORTH_PARSER_OFFSETS_ONLY 1
+
+#include <cassert>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/line_index.hpp>
+
+static void
+test_utf32()
+{
+  const std::u32string source = U"foo\n  [bar, \"bäz\"]\n(quux)";
+  const plorth::parser::u32line_index lines(source);
+  auto current = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(current, end, position);
+
+  assert(!!result);
+  assert(result->size() == 3);
+  assert(position.line == 1);
+  assert(position.column == 1);
+  assert(position.offset == source.length());
+
+  const auto& array = result->at(1);
+
+  assert(array->position().line == 1);
+  assert(array->position().column == 1);
+  assert(array->span().begin == 6);
+  assert(array->span().end == 18);
+  assert(lines.locate(array->span().begin).line == 2);
+  assert(lines.locate(array->span().begin).column == 3);
+  assert(lines.locate(result->at(2)->span().begin).line == 3);
+}
+
+static void
+test_utf8()
+{
+  const std::string source = u8"\"ää\" foo\n  bar";
+  const plorth::parser::line_index lines(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(source, position);
+
+  assert(!!result);
+  assert(result->size() == 3);
+  assert(position.offset == source.length());
+  assert(result->at(1)->span().begin == 7);
+  assert(lines.locate(result->at(1)->span().begin).column == 6);
+  assert(lines.locate(result->at(2)->span().begin).line == 2);
+  assert(lines.locate(result->at(2)->span().begin).column == 3);
+}
+
+static void
+test_error()
+{
+  const std::string source = "foo\n  [bar";
+  const plorth::parser::line_index lines(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(source, position);
+
+  assert(!result);
+  assert(result.error().position.line == 1);
+  assert(result.error().position.column == 1);
+
+  const auto location = lines.locate(result.error().position.offset);
+
+  assert(location.line == 2);
+  assert(location.column == 3);
+}
+
+int
+main()
+{
+  test_utf32();
+  test_utf8();
+  test_error();
+}
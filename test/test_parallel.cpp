@@ -0,0 +1,177 @@
+#include <atomic>
+#include <cassert>
+
+#include <plorth/parser/parallel.hpp>
+
+#include "./compare.hpp"
+
+// Builder which counts the arrays it constructs, so that tests can tell
+// whether any part of the source code was parsed more than once.
+class counting_builder : public plorth::parser::ast::builder<>
+{
+public:
+  explicit counting_builder(std::atomic<std::size_t>& count)
+    : m_count(&count) {}
+
+  array_type make_array(
+    const plorth::parser::position& position,
+    std::uint64_t end,
+    array_container_type&& elements
+  ) const
+  {
+    ++*m_count;
+
+    return builder::make_array(position, end, std::move(elements));
+  }
+
+private:
+  std::atomic<std::size_t>* m_count;
+};
+
+static void
+check(const std::u32string& source, std::size_t min_chunk_size = 16)
+{
+  plorth::parser::thread_pool pool(4);
+  auto current1 = std::cbegin(source);
+  auto current2 = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position1 = { U"<test>", 3, 5, 7 };
+  plorth::parser::position position2 = position1;
+  const auto result1 = plorth::parser::parse(current1, end, position1);
+  const auto result2 = plorth::parser::parse_parallel(
+    current2,
+    end,
+    position2,
+    pool,
+    plorth::parser::ast::builder<>(),
+    min_chunk_size
+  );
+
+  assert(!!result1 == !!result2);
+  assert(current1 == current2);
+  assert(position1.line == position2.line);
+  assert(position1.column == position2.column);
+  assert(position1.offset == position2.offset);
+
+  if (!result1)
+  {
+    assert(result1.error().message == result2.error().message);
+    assert(result1.error().position.line == result2.error().position.line);
+    assert(
+      result1.error().position.column == result2.error().position.column
+    );
+    return;
+  }
+
+  assert(result1->size() == result2->size());
+  for (std::size_t i = 0; i < result1->size(); ++i)
+  {
+    compare(result1->at(i), result2->at(i));
+  }
+}
+
+static std::u32string
+generate(std::size_t count)
+{
+  std::u32string source = U"# leading comment\n\n";
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    source += U"(dup 1 + swap \"multi\nline \\u00e4 string\") -> word\n";
+    source += U"  [1, 2, {\"key\": 'value', \"list\": [a, b, c]}] drop";
+    source += U" # comment with \"quote\n";
+    source += U"'tab\tseparated' \u00e4\u00f6 foo:bar ";
+  }
+  source += U"end";
+
+  return source;
+}
+
+static void
+test_identical_to_sequential()
+{
+  check(generate(1));
+  check(generate(50));
+}
+
+static void
+test_chunks_are_parsed_once()
+{
+  plorth::parser::thread_pool pool(4);
+  std::u32string source = U"# comment\n";
+  std::atomic<std::size_t> count(0);
+
+  for (int i = 0; i < 2001; ++i)
+  {
+    source += U"[a] # comment\n ";
+  }
+  source += U"[b]";
+
+  auto current = std::cbegin(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse_parallel(
+    current,
+    std::cend(source),
+    position,
+    pool,
+    counting_builder(count),
+    16
+  );
+
+  assert(!!result);
+  assert(result->size() == 2002);
+  // Valid source code must not fall back to the sequential parser.
+  assert(count == 2002);
+  assert(position.line == 2003);
+}
+
+static void
+test_errors()
+{
+  auto source = generate(50);
+
+  // Trailing whitespace.
+  check(source + U"\n");
+  // Unbalanced brackets.
+  check(source + U" [1, 2");
+  // Error which the structural index does not notice.
+  source.insert(source.length() / 2, U" \"\\x\" ");
+  check(source);
+  check(generate(50) + U" ->");
+}
+
+static void
+test_invalid_characters()
+{
+  check(U"foo \x01 bar", 1);
+  check(U"\"a b\">,bar\\ \\", 1);
+  check(U"\\x-,\"a b\" c", 1);
+  check(U"foo ] bar", 1);
+  check(U"foo ) bar", 1);
+  check(U"foo # comment\n\x7f bar", 1);
+  check(U"-> \"a b\" 'c d' e", 1);
+  check(U"-> # comment\n\"a b\" c", 1);
+  check(generate(50) + U"\x01" + generate(50));
+}
+
+static void
+test_thread_pool()
+{
+  plorth::parser::thread_pool pool(2);
+  auto a = pool.submit([]() { return 1; });
+  auto b = pool.submit([]() { return std::u32string(U"foo"); });
+
+  assert(pool.size() == 2);
+  assert(a.get() == 1);
+  assert(b.get() == U"foo");
+}
+
+int
+main()
+{
+  test_identical_to_sequential();
+  test_chunks_are_parsed_once();
+  test_errors();
+  test_invalid_characters();
+  test_thread_pool();
+}
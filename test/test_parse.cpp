@@ -35,9 +35,27 @@ test_successful_parse()
   assert(!!parse(U"foo \"bar\" [baz]"));
 }
 
+static void
+test_positions_share_file_name()
+{
+  const std::u32string source(U"[foo]\n\"bar\"");
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"/path/to/file.plorth", 1, 1 };
+  const auto result = plorth::parser::parse(begin, end, position);
+
+  assert(!!result);
+  assert(result->size() == 2);
+  assert(result->at(0)->position().file == U"/path/to/file.plorth");
+  assert(result->at(0)->position().file.id() == position.file.id());
+  assert(result->at(1)->position().file.id() == position.file.id());
+  assert(result->at(1)->position().line == 2);
+}
+
 int
 main()
 {
   test_parse_error();
   test_successful_parse();
+  test_positions_share_file_name();
 }
@@ -0,0 +1,100 @@
+#include <cassert>
+
+#include <plorth/parser/parse_tree.hpp>
+
+using plorth::parser::parse_tree;
+using plorth::parser::ast::token;
+
+static auto
+parse(const std::u32string& source)
+{
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  return parse_tree::parse(begin, end, position);
+}
+
+static void
+test_parse_error()
+{
+  const auto result = parse(U"[foo");
+
+  assert(!result);
+  assert(result.error().position.line == 1);
+  assert(result.error().position.column == 1);
+}
+
+static void
+test_empty()
+{
+  const auto result = parse(U"");
+
+  assert(!!result);
+  assert(result->size() == 0);
+  assert(result->begin() == result->end());
+}
+
+static void
+test_roots()
+{
+  const auto result = parse(U"[foo, \"bar\"] (baz -> quux) {\"a\": b}");
+  std::size_t count = 0;
+
+  assert(!!result);
+
+  const auto& tree = result->tree();
+
+  assert(result->size() == 3);
+  assert(tree.type(result->roots()[0]) == token::type::array);
+  assert(tree.type(result->roots()[1]) == token::type::quote);
+  assert(tree.type(result->roots()[2]) == token::type::object);
+  for (const auto root : *result)
+  {
+    assert(root < tree.size());
+    ++count;
+  }
+  assert(count == 3);
+}
+
+static void
+test_copies_share_tree()
+{
+  const auto result = parse(U"foo bar");
+  const parse_tree copy = *result;
+
+  assert(copy.size() == 2);
+  assert(&copy.tree() == &result->tree());
+}
+
+static void
+test_to_ast()
+{
+  const std::u32string source(U"[foo]\n(bar)");
+  std::vector<std::shared_ptr<token>> tokens;
+
+  {
+    const auto result = parse(source);
+
+    assert(!!result);
+    tokens = result->to_ast(plorth::parser::u32line_index(source));
+  }
+
+  // Tokens own their memory, so they outlive the parse tree.
+  assert(tokens.size() == 2);
+  assert(tokens[0]->type() == token::type::array);
+  assert(tokens[1]->type() == token::type::quote);
+  assert(tokens[1]->position().line == 2);
+  assert(tokens[1]->position().column == 1);
+  assert(tokens[1]->position().file == U"<test>");
+}
+
+int
+main()
+{
+  test_parse_error();
+  test_empty();
+  test_roots();
+  test_copies_share_tree();
+  test_to_ast();
+}
@@ -0,0 +1,150 @@
+#include <cassert>
+
+#include <plorth/parser/push_parser.hpp>
+
+#include "./compare.hpp"
+
+using plorth::parser::ast::token;
+
+static const std::string source =
+  u8"# comment \"with quote\n"
+  u8"(dup 1 + \"str)ing\" 'esc\\'aped') -> my-word\n"
+  u8"->\n# between\n other-word foo\"bar\n"
+  u8"[1, 2, {\"key\": 'value', \"k:2\": :colon, \"nested\": [a, (b c)]}]\r\n"
+  u8"\u00e4\u00f6 \u3000 \"p\u00e4\u00e4\" foo#bar {} []";
+
+// Feeds the source code to push parser in chunks of given size, and checks
+// that the result is identical to one returned by parse().
+static void
+check(const std::string& input, std::size_t chunk_size)
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto expected = plorth::parser::parse(input, position);
+  plorth::parser::push_parser parser({ U"<test>", 1, 1 });
+  std::vector<std::shared_ptr<token>> tokens;
+  auto result = plorth::parser::parse_result::ok(tokens);
+
+  for (std::size_t i = 0; i < input.length() && result; i += chunk_size)
+  {
+    result = parser.feed(input.substr(i, chunk_size));
+    if (result)
+    {
+      tokens.insert(std::end(tokens), std::begin(*result), std::end(*result));
+    }
+  }
+  if (result)
+  {
+    result = parser.finish();
+  }
+  if (result)
+  {
+    tokens.insert(std::end(tokens), std::begin(*result), std::end(*result));
+  }
+
+  assert(!!expected == !!result);
+  if (!expected)
+  {
+    assert(expected.error().message == result.error().message);
+    assert(
+      expected.error().position.offset == result.error().position.offset
+    );
+    return;
+  }
+  assert(expected->size() == tokens.size());
+  for (std::size_t i = 0; i < tokens.size(); ++i)
+  {
+    compare(expected->at(i), tokens[i]);
+  }
+}
+
+static void
+test_identical_to_parse()
+{
+  for (std::size_t size = 1; size <= source.length(); ++size)
+  {
+    check(source, size);
+  }
+}
+
+static void
+test_errors()
+{
+  for (std::size_t chunk_size = 1; chunk_size < 8; ++chunk_size)
+  {
+    check(source + " [1, 2", chunk_size);
+    check(source + " \"\\x\" foo", chunk_size);
+    check(source + "\n", chunk_size);
+    check(source + " ->", chunk_size);
+    check(source + " -> (foo)", chunk_size);
+  }
+}
+
+static void
+test_quote_after_word_definition()
+{
+  const std::string inputs[] = {
+    "'x'-> \"a b\"\\",
+    u8"->\u00a0\"a b\"'x'#\"k\":",
+    "-> '->'x''->bar\"foo",
+    "(-> \"a) \"b)\" c",
+    "{\"k\": -> \"a, \"b\": c}",
+  };
+
+  for (const auto& input : inputs)
+  {
+    for (std::size_t size = 1; size <= input.length(); ++size)
+    {
+      check(input, size);
+    }
+  }
+}
+
+static void
+test_tokens_returned_when_complete()
+{
+  plorth::parser::push_parser parser;
+
+  auto result = parser.feed("foo (bar");
+  assert(!!result);
+  assert(result->size() == 1);
+
+  result = parser.feed(" \"b)az");
+  assert(!!result);
+  assert(result->empty());
+
+  result = parser.feed("\") -> ");
+  assert(!!result);
+  assert(result->size() == 1);
+  assert(result->at(0)->type() == token::type::quote);
+  assert(parser.buffered() == 4);
+
+  result = parser.feed("name");
+  assert(!!result);
+  assert(result->empty());
+
+  result = parser.finish();
+  assert(!!result);
+  assert(result->size() == 1);
+  assert(result->at(0)->type() == token::type::word);
+  assert(parser.buffered() == 0);
+}
+
+static void
+test_error_is_sticky()
+{
+  plorth::parser::push_parser parser;
+
+  assert(!parser.feed("] foo"));
+  assert(!parser.feed("bar"));
+  assert(!parser.finish());
+}
+
+int
+main()
+{
+  test_identical_to_parse();
+  test_errors();
+  test_quote_after_word_definition();
+  test_tokens_returned_when_complete();
+  test_error_is_sticky();
+}
@@ -4,6 +4,14 @@
 
 using plorth::parser::parse_quote;
 
+// Eager quotes carry nothing but their children; state of lazy quotes lives
+// in a subclass.
+static_assert(
+  sizeof(plorth::parser::ast::quote)
+  == sizeof(plorth::parser::ast::token)
+  + sizeof(plorth::parser::ast::quote::container_type)
+);
+
 static auto
 parse(const std::u32string& source)
 {
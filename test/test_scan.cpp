@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cassert>
+
+#include <plorth/parser.hpp>
+
+namespace scan = plorth::parser::scan;
+
+static const std::u32string alphabet =
+  U" \t\n\v\f\r\"'\\#()[]{},:"
+  U"->aZ9~\x7f\xe4\x1f600";
+
+// Generates every string of given length from a small alphabet which
+// contains all kinds of characters the kernels classify, in pseudo-random
+// order.
+static std::u32string
+generate(std::size_t length, unsigned seed)
+{
+  std::u32string result;
+
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    result.append(1, alphabet[(seed >> 16) % alphabet.length()]);
+  }
+
+  return result;
+}
+
+static void
+test_kernels_match_scalar()
+{
+  for (unsigned seed = 0; seed < 2000; ++seed)
+  {
+    const auto input = generate(seed % 40, seed);
+    const auto first = input.data();
+    const auto last = first + input.length();
+
+    assert(
+      scan::find_string_delimiter(first, last, '"')
+      == scan::scalar::find_string_delimiter(first, last, '"')
+    );
+    assert(
+      scan::find_string_delimiter(first, last, '\'')
+      == scan::scalar::find_string_delimiter(first, last, '\'')
+    );
+    assert(
+      scan::find_line_end(first, last)
+      == scan::scalar::find_line_end(first, last)
+    );
+    assert(
+      scan::skip_blanks(first, last) == scan::scalar::skip_blanks(first, last)
+    );
+    assert(
+      scan::skip_word(first, last) == scan::scalar::skip_word(first, last)
+    );
+  }
+}
+
+static void
+test_long_runs()
+{
+  const std::u32string blanks(37, U' ');
+  const std::u32string word(37, U'a');
+  const auto blanks_end = blanks.data() + blanks.length();
+  const auto word_end = word.data() + word.length();
+
+  assert(scan::skip_blanks(blanks.data(), blanks_end) == blanks_end);
+  assert(scan::find_line_end(blanks.data(), blanks_end) == blanks_end);
+  assert(scan::skip_word(word.data(), word_end) == word_end);
+  assert(scan::skip_blanks(word.data(), word_end) == word.data());
+  assert(
+    scan::find_string_delimiter(word.data(), word_end, '"') == word_end
+  );
+}
+
+// Compares the kernels for UTF-8 input against the UTF-32 ones, up to the
+// first non-ASCII character, at which the former must stop.
+static void
+test_ascii_kernels()
+{
+  for (unsigned seed = 0; seed < 2000; ++seed)
+  {
+    const auto input = generate(seed % 40, seed);
+    std::string bytes;
+    std::size_t ascii = input.length();
+
+    for (std::size_t i = 0; i < input.length(); ++i)
+    {
+      if (input[i] < 0x80)
+      {
+        bytes.append(1, static_cast<char>(input[i]));
+      } else {
+        bytes.append("\xc3\xa4");
+        ascii = std::min(ascii, i);
+      }
+    }
+
+    const auto first = bytes.data();
+    const auto last = first + bytes.length();
+    const auto limit = input.data() + ascii;
+    const auto check = [&](const char* result, const char32_t* expected)
+    {
+      assert(result - first == expected - input.data());
+    };
+
+    check(
+      scan::ascii::find_string_delimiter(first, last, '"'),
+      scan::scalar::find_string_delimiter(input.data(), limit, '"')
+    );
+    check(
+      scan::ascii::find_line_end(first, last),
+      scan::scalar::find_line_end(input.data(), limit)
+    );
+    check(
+      scan::ascii::skip_blanks(first, last),
+      scan::scalar::skip_blanks(input.data(), limit)
+    );
+    check(
+      scan::ascii::skip_word(first, last),
+      scan::scalar::skip_word(input.data(), limit)
+    );
+  }
+}
+
+// Compares the vectorized kernels for UTF-8 input against the scalar ones,
+// on arbitrary bytes including ones which are not ASCII.
+static void
+test_ascii_kernels_match_scalar()
+{
+  static const std::string bytes_alphabet =
+    " \t\n\v\f\r\"'\\#()[]{},:->aZ9~\x7f\x1f\x80\xc3\xa4\xff";
+
+  for (unsigned seed = 0; seed < 4000; ++seed)
+  {
+    std::string input;
+    unsigned state = seed;
+
+    for (std::size_t i = 0; i < seed % 100; ++i)
+    {
+      state = state * 1103515245 + 12345;
+      input.append(1, bytes_alphabet[(state >> 16) % bytes_alphabet.length()]);
+    }
+
+    const auto first = input.data();
+    const auto last = first + input.length();
+
+    assert(
+      scan::ascii::find_string_delimiter(first, last, '"')
+      == scan::ascii::scalar::find_string_delimiter(first, last, '"')
+    );
+    assert(
+      scan::ascii::find_string_delimiter(first, last, '\'')
+      == scan::ascii::scalar::find_string_delimiter(first, last, '\'')
+    );
+    assert(
+      scan::ascii::find_line_end(first, last)
+      == scan::ascii::scalar::find_line_end(first, last)
+    );
+    assert(
+      scan::ascii::skip_blanks(first, last)
+      == scan::ascii::scalar::skip_blanks(first, last)
+    );
+    assert(
+      scan::ascii::skip_word(first, last)
+      == scan::ascii::scalar::skip_word(first, last)
+    );
+  }
+}
+
+static void
+test_long_ascii_runs()
+{
+  const std::string blanks(77, ' ');
+  const std::string word(77, 'a');
+  const auto blanks_end = blanks.data() + blanks.length();
+  const auto word_end = word.data() + word.length();
+
+  assert(scan::ascii::skip_blanks(blanks.data(), blanks_end) == blanks_end);
+  assert(scan::ascii::find_line_end(blanks.data(), blanks_end) == blanks_end);
+  assert(scan::ascii::skip_word(word.data(), word_end) == word_end);
+  assert(scan::ascii::skip_blanks(word.data(), word_end) == word.data());
+  assert(
+    scan::ascii::find_string_delimiter(word.data(), word_end, '"')
+    == word_end
+  );
+}
+
+static void
+compare(
+  const std::shared_ptr<plorth::parser::ast::token>& a,
+  const std::shared_ptr<plorth::parser::ast::token>& b
+)
+{
+  assert(a->type() == b->type());
+  assert(a->position().line == b->position().line);
+  assert(a->position().column == b->position().column);
+  assert(a->span().length() <= b->span().length());
+}
+
+static void
+test_positions_match_non_contiguous_input()
+{
+  const std::string source =
+    u8"# long comment with some text in it\r\n"
+    u8"\t\t    \"a string which is long enough to be vectorized\"\n"
+    u8"       some-long-symbol-name-here     -> another-long-word-name\n"
+    u8"'string with\nline break and \\u00e4 escape and more text after it'\n"
+    u8"   \u00e4\u00e4\u00e4-unicode-word-\u00e4     ( quote-contents )";
+  const auto decoded = plorth::parser::utf8::decode(source);
+  auto current = std::cbegin(decoded);
+  const auto end = std::cend(decoded);
+  plorth::parser::position position1 = { U"<test>", 1, 1 };
+  plorth::parser::position position2 = { U"<test>", 1, 1 };
+  const auto result1 = plorth::parser::parse(current, end, position1);
+  const auto result2 = plorth::parser::parse(source, position2);
+
+  assert(!!result1);
+  assert(!!result2);
+  assert(result1->size() == result2->size());
+  assert(position1.line == position2.line);
+  assert(position1.column == position2.column);
+  assert(position1.offset == decoded.length());
+
+  for (std::size_t i = 0; i < result1->size(); ++i)
+  {
+    compare(result1->at(i), result2->at(i));
+  }
+}
+
+int
+main()
+{
+  test_kernels_match_scalar();
+  test_long_runs();
+  test_ascii_kernels();
+  test_ascii_kernels_match_scalar();
+  test_long_ascii_runs();
+  test_positions_match_non_contiguous_input();
+}
@@ -0,0 +1,231 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+
+using plorth::parser::ast::array;
+using plorth::parser::ast::object;
+using plorth::parser::ast::string;
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::word;
+
+static auto
+parse(const std::u32string& source, bool source_views = true)
+{
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  plorth::parser::ast::builder<> builder;
+
+  builder.set_source_views(source_views);
+
+  return plorth::parser::parse(begin, end, position, builder);
+}
+
+static auto
+parse_deferred(const std::u32string& source)
+{
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  plorth::parser::ast::builder<> builder;
+
+  builder.set_deferred_escapes(true);
+
+  return plorth::parser::parse(begin, end, position, builder);
+}
+
+static bool
+is_inside(const std::u32string_view& view, const std::u32string& source)
+{
+  return view.data() >= source.data()
+    && view.data() + view.length() <= source.data() + source.length();
+}
+
+static void
+test_string_refers_to_source()
+{
+  const std::u32string source = U"\"foo\"";
+  const auto result = parse(source);
+
+  assert(!!result);
+
+  const auto token = std::static_pointer_cast<string>(result->at(0));
+
+  assert(token->is_source_view());
+  assert(token->view() == U"foo");
+  assert(is_inside(token->view(), source));
+  assert(!token->value().compare(U"foo"));
+  assert(token->value().data() != token->view().data());
+}
+
+static void
+test_string_with_escape_sequence_is_copied()
+{
+  const std::u32string source = U"\"foo\\nbar\"";
+  const auto result = parse(source);
+
+  assert(!!result);
+
+  const auto token = std::static_pointer_cast<string>(result->at(0));
+
+  assert(!token->is_source_view());
+  assert(token->view() == U"foo\nbar");
+  assert(!token->value().compare(U"foo\nbar"));
+}
+
+static void
+test_empty_string()
+{
+  const std::u32string source = U"''";
+  const auto result = parse(source);
+
+  assert(!!result);
+
+  const auto token = std::static_pointer_cast<string>(result->at(0));
+
+  assert(token->view().empty());
+  assert(token->value().empty());
+}
+
+static void
+test_symbol_refers_to_source()
+{
+  const std::u32string source = U"foo -> bar";
+  const auto result = parse(source);
+
+  assert(!!result);
+  assert(result->size() == 2);
+
+  const auto s = std::static_pointer_cast<symbol>(result->at(0));
+  const auto w = std::static_pointer_cast<word>(result->at(1));
+
+  assert(s->is_source_view());
+  assert(s->view() == U"foo");
+  assert(is_inside(s->view(), source));
+  assert(s->id() == U"foo");
+  assert(w->symbol()->is_source_view());
+  assert(w->symbol()->view() == U"bar");
+}
+
+static void
+test_object_keys_are_copied()
+{
+  const std::u32string source = U"{\"foo\": \"bar\"}";
+  const auto result = parse(source);
+
+  assert(!!result);
+
+  const auto token = std::static_pointer_cast<object>(result->at(0));
+  const auto& property = token->properties().at(0);
+  const auto value = std::static_pointer_cast<string>(property.second);
+
+  assert(property.first == U"foo");
+  assert(!is_inside(static_cast<std::u32string_view>(property.first), source));
+  assert(value->is_source_view());
+}
+
+static void
+test_source_views_disabled()
+{
+  const std::u32string source = U"[\"foo\", bar]";
+  const auto result = parse(source, false);
+
+  assert(!!result);
+
+  const auto token = std::static_pointer_cast<array>(result->at(0));
+  const auto s = std::static_pointer_cast<string>(token->elements()[0]);
+  const auto sym = std::static_pointer_cast<symbol>(token->elements()[1]);
+
+  assert(!s->is_source_view());
+  assert(!is_inside(s->view(), source));
+  assert(!sym->is_source_view());
+  assert(sym->id() == U"bar");
+}
+
+static void
+test_non_contiguous_source_is_copied()
+{
+  const std::string source = u8"\"foo\" bar";
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  plorth::parser::ast::builder<> builder;
+
+  builder.set_source_views(true);
+
+  const auto result = plorth::parser::parse(source, position, builder);
+
+  assert(!!result);
+
+  const auto s = std::static_pointer_cast<string>(result->at(0));
+  const auto sym = std::static_pointer_cast<symbol>(result->at(1));
+
+  assert(!s->is_source_view());
+  assert(!s->value().compare(U"foo"));
+  assert(!sym->is_source_view());
+  assert(sym->id() == U"bar");
+}
+
+static void
+test_deferred_escapes()
+{
+  const std::u32string source = U"\"foo\\nbar\" 'ba\\u0072' \"qux\"";
+  const auto result = parse_deferred(source);
+
+  assert(!!result);
+  assert(result->size() == 3);
+
+  const auto escaped = std::static_pointer_cast<string>(result->at(0));
+  const auto hex = std::static_pointer_cast<string>(result->at(1));
+  const auto plain = std::static_pointer_cast<string>(result->at(2));
+
+  assert(escaped->is_source_view());
+  assert(escaped->has_escapes());
+  assert(escaped->span().end == 10);
+  assert(!escaped->value().compare(U"foo\nbar"));
+  assert(escaped->view() == U"foo\nbar");
+  assert(hex->has_escapes());
+  assert(hex->view() == U"bar");
+  assert(!hex->value().compare(U"bar"));
+  assert(!plain->has_escapes());
+  assert(!plain->value().compare(U"qux"));
+  assert(result->at(2)->position().column == 23);
+}
+
+static void
+test_deferred_escapes_are_checked()
+{
+  static const char32_t* sources[] =
+  {
+    U"\"foo\\x\"",
+    U"'\\u12'",
+    U"\"\\ud805\"",
+    U"[\"a\", \"b\\",
+  };
+
+  for (const auto source : sources)
+  {
+    const auto deferred = parse_deferred(source);
+    const auto eager = parse(source);
+
+    assert(!deferred);
+    assert(!eager);
+    assert(deferred.error().message == eager.error().message);
+    assert(deferred.error().position.line == eager.error().position.line);
+    assert(
+      deferred.error().position.column == eager.error().position.column
+    );
+  }
+}
+
+int
+main()
+{
+  test_string_refers_to_source();
+  test_string_with_escape_sequence_is_copied();
+  test_empty_string();
+  test_symbol_refers_to_source();
+  test_object_keys_are_copied();
+  test_source_views_disabled();
+  test_non_contiguous_source_is_copied();
+  test_deferred_escapes();
+  test_deferred_escapes_are_checked();
+}
@@ -4,6 +4,14 @@
 
 using plorth::parser::parse_string;
 
+// Eager string literals carry nothing but their contents; state of ones
+// referring to the source code lives in a subclass.
+static_assert(
+  sizeof(plorth::parser::ast::string)
+  == sizeof(plorth::parser::ast::token)
+  + sizeof(plorth::parser::ast::string::value_type)
+);
+
 static auto
 parse(const std::u32string& source)
 {
@@ -0,0 +1,166 @@
+#include <cassert>
+
+#include <plorth/parser/structural_index.hpp>
+
+using plorth::parser::structural_index;
+using plorth::parser::ast::array;
+using plorth::parser::ast::object;
+using plorth::parser::ast::quote;
+
+static std::u32string
+characters(const structural_index& index)
+{
+  std::u32string result;
+
+  for (const auto& entry : index)
+  {
+    result.append(1, entry.character);
+  }
+
+  return result;
+}
+
+static void
+test_structural_characters()
+{
+  const structural_index index(
+    U"[1, \"a,]\"] # comment (\n{'k': foo:bar, \"x\\\"\": ()}"
+  );
+
+  assert(characters(index) == U"[,\"\"]{'':,\"\":()}");
+  assert(index[0].offset == 0);
+  assert(index[2].offset == 4);
+  assert(index.roots() == 2);
+  assert(index.balanced());
+}
+
+static void
+test_matching()
+{
+  const structural_index index(U"[(a) {}]");
+
+  assert(index[0].partner == 5);
+  assert(index[5].partner == 0);
+  assert(index[1].partner == 2);
+  assert(index[3].partner == 4);
+}
+
+static void
+test_children()
+{
+  const structural_index index(
+    U"[1, 'two', [3],] (a b -> c \"d\" (e)) {\"a\": [x], \"b\": 'y'} {}"
+  );
+
+  assert(index[0].children == 3);
+  assert(index[5].children == 1);
+  assert(index[9].children == 5);
+  assert(index[12].children == 1);
+  assert(index[15].children == 2);
+  assert(index[19].children == 1);
+  assert(index[28].children == 0);
+  assert(index.roots() == 4);
+}
+
+static void
+test_unbalanced()
+{
+  assert(!structural_index(U"[1, 2").balanced());
+  assert(!structural_index(U"(a]").balanced());
+  assert(!structural_index(U"\"abc").balanced());
+  assert(!structural_index(U"'abc\\'").balanced());
+  assert(structural_index(U"'abc\\''").balanced());
+  assert(!structural_index(U"foo \x01 bar").balanced());
+  assert(!structural_index(U"foo, bar").balanced());
+  assert(!structural_index(U"(foo, bar)").balanced());
+  assert(structural_index(U"[foo, bar]").balanced());
+}
+
+static void
+test_word_definition_with_quote()
+{
+  const structural_index index(U"-> \"a b\" 'c'");
+
+  assert(characters(index) == U"''");
+  assert(index.roots() == 3);
+  assert(index.root_spans()[0].begin == 0);
+  assert(index.root_spans()[0].end == 5);
+  assert(index.root_spans()[1].begin == 6);
+  assert(index.root_spans()[1].end == 8);
+  assert(index.balanced());
+}
+
+static void
+test_offset()
+{
+  const structural_index index(U"(a)", 10);
+
+  assert(index[0].offset == 10);
+  assert(index[1].offset == 12);
+}
+
+static void
+test_parse_indexed()
+{
+  const std::u32string source =
+    U"[1, 2, 3] {\"a\": (x y -> z), 'b': []} (foo \"bar\")";
+  auto current = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse_indexed(current, end, position);
+
+  assert(!!result);
+  assert(result->size() == 3);
+  assert(result->capacity() == 3);
+
+  const auto a = std::static_pointer_cast<array>(result->at(0));
+  const auto o = std::static_pointer_cast<object>(result->at(1));
+  const auto q = std::static_pointer_cast<quote>(result->at(2));
+  const auto inner = std::static_pointer_cast<quote>(
+    o->properties()[0].second
+  );
+
+  assert(a->elements().size() == 3);
+  assert(a->elements().capacity() == 3);
+  assert(o->properties().size() == 2);
+  assert(o->properties().capacity() == 2);
+  assert(inner->children().size() == 3);
+  assert(inner->children().capacity() == 3);
+  assert(q->children().capacity() == 2);
+  assert(q->position().column == 38);
+}
+
+static void
+test_parse_indexed_error()
+{
+  const std::u32string source = U"[1, 2";
+  auto current1 = std::cbegin(source);
+  auto current2 = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position1 = { U"<test>", 1, 1 };
+  plorth::parser::position position2 = { U"<test>", 1, 1 };
+  const auto result1 = plorth::parser::parse(current1, end, position1);
+  const auto result2 = plorth::parser::parse_indexed(
+    current2,
+    end,
+    position2
+  );
+
+  assert(!result1);
+  assert(!result2);
+  assert(result1.error().message == result2.error().message);
+  assert(result1.error().position.column == result2.error().position.column);
+}
+
+int
+main()
+{
+  test_structural_characters();
+  test_matching();
+  test_children();
+  test_unbalanced();
+  test_word_definition_with_quote();
+  test_offset();
+  test_parse_indexed();
+  test_parse_indexed_error();
+}
@@ -0,0 +1,205 @@
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+#include <plorth/parser.hpp>
+
+using plorth::parser::interned_string;
+using plorth::parser::symbol_table;
+using plorth::parser::ast::object;
+using plorth::parser::ast::quote;
+using plorth::parser::ast::symbol;
+
+static std::size_t allocations = 0;
+
+// GCC cannot see that the replacement operators below are paired correctly.
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void*
+operator new(std::size_t size)
+{
+  ++allocations;
+  if (auto pointer = std::malloc(size))
+  {
+    return pointer;
+  }
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+static auto
+parse(
+  const std::u32string& source,
+  const plorth::parser::ast::builder<>& builder
+)
+{
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  return plorth::parser::parse(begin, end, position, builder);
+}
+
+static void
+test_intern()
+{
+  symbol_table table;
+  const auto a = table.intern(U"foo");
+  const auto b = table.intern(std::u32string(U"foo"));
+  const auto c = table.intern(U"bar");
+
+  assert(a == b);
+  assert(a.id() == b.id());
+  assert(a != c);
+  assert(a.id() != c.id());
+  assert(a.is_interned());
+  assert(table.size() == 2);
+}
+
+static void
+test_compare_across_tables()
+{
+  symbol_table table1;
+  symbol_table table2;
+  const auto a = table1.intern(U"foo");
+  const auto b = table2.intern(U"foo");
+  const auto c = table1.intern(U"bar");
+  const interned_string d(U"foo");
+
+  assert(a == b);
+  assert(a.id() != b.id());
+  assert(a != c);
+  assert(b != c);
+  assert(a == d);
+  assert(d == b);
+  assert(!d.is_interned());
+}
+
+static void
+test_source_views_with_symbol_table()
+{
+  symbol_table table;
+  plorth::parser::ast::builder<> builder(table);
+
+  builder.set_source_views(true);
+
+  const auto result = parse(U"foo foo", builder);
+
+  assert(!!result);
+
+  const auto s1 = std::static_pointer_cast<symbol>(result->at(0));
+  const auto s2 = std::static_pointer_cast<symbol>(result->at(1));
+
+  assert(!s1->is_source_view());
+  assert(s1->id().is_interned());
+  assert(s1->id().id() == s2->id().id());
+  assert(table.size() == 1);
+}
+
+static void
+test_interned_string()
+{
+  const interned_string a(U"foo");
+  const interned_string b(U"foo");
+  const interned_string empty;
+
+  assert(a == b);
+  assert(a.id() != b.id());
+  assert(a == U"foo");
+  assert(U"foo" == a);
+  assert(a == std::u32string(U"foo"));
+  assert(a != U"bar");
+  assert(a.length() == 3);
+  assert(empty.empty());
+  assert(empty == U"");
+  assert(std::hash<interned_string>()(a) == std::hash<interned_string>()(b));
+}
+
+static void
+test_short_strings_are_stored_inline()
+{
+  const std::u32string text(U"dup");
+  const auto before = allocations;
+  const interned_string a(text);
+  const interned_string b(a);
+  const interned_string c(std::u32string(U"+"));
+
+  assert(allocations == before);
+  assert(a == b);
+  assert(a.id() != b.id());
+  assert(c == U"+");
+}
+
+static void
+test_long_strings_are_shared()
+{
+  const interned_string a(U"/path/to/some/file.plorth");
+  const auto before = allocations;
+  const interned_string b(a);
+
+  assert(allocations == before);
+  assert(a.id() == b.id());
+  assert(b == U"/path/to/some/file.plorth");
+}
+
+static void
+test_parse_with_symbol_table()
+{
+  symbol_table table;
+  const plorth::parser::ast::builder<> builder(table);
+  const auto result = parse(U"(dup dup) {\"dup\": dup}", builder);
+
+  assert(!!result);
+
+  const auto q = std::static_pointer_cast<quote>(result->at(0));
+  const auto o = std::static_pointer_cast<object>(result->at(1));
+  const auto s1 = std::static_pointer_cast<symbol>(q->children()[0]);
+  const auto s2 = std::static_pointer_cast<symbol>(q->children()[1]);
+  const auto s3 = std::static_pointer_cast<symbol>(o->properties()[0].second);
+
+  assert(s1->id().id() == s2->id().id());
+  assert(s1->id().id() == s3->id().id());
+  assert(o->properties()[0].first.id() == s1->id().id());
+  assert(table.size() == 1);
+}
+
+static void
+test_parse_without_symbol_table()
+{
+  const auto result = parse(U"dup dup", plorth::parser::ast::builder<>());
+
+  assert(!!result);
+
+  const auto s1 = std::static_pointer_cast<symbol>(result->at(0));
+  const auto s2 = std::static_pointer_cast<symbol>(result->at(1));
+
+  assert(s1->id() == s2->id());
+  assert(s1->id().id() != s2->id().id());
+}
+
+int
+main()
+{
+  test_intern();
+  test_compare_across_tables();
+  test_source_views_with_symbol_table();
+  test_interned_string();
+  test_short_strings_are_stored_inline();
+  test_long_strings_are_shared();
+  test_parse_with_symbol_table();
+  test_parse_without_symbol_table();
+}
@@ -0,0 +1,92 @@
+#include <cassert>
+
+#include <plorth/parser/token_stream.hpp>
+
+using plorth::parser::ast::token;
+
+static void
+test_yields_same_tokens_as_parse()
+{
+  const std::string source = u8"foo \"bar\" [1, 2] -> baz\n(a b) {\"c\": d}";
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto expected = plorth::parser::parse(source, position);
+  auto stream = plorth::parser::parse_lazily(source, { U"<test>", 1, 1 });
+  std::size_t index = 0;
+
+  assert(!!expected);
+  for (const auto& result : stream)
+  {
+    assert(!!result);
+    assert(index < expected->size());
+    assert((*result)->type() == expected->at(index)->type());
+    assert((*result)->span().begin == expected->at(index)->span().begin);
+    assert((*result)->span().end == expected->at(index)->span().end);
+    ++index;
+  }
+  assert(index == expected->size());
+  assert(stream.position().offset == position.offset);
+}
+
+static void
+test_parses_one_token_at_a_time()
+{
+  const std::u32string source = U"foo bar (";
+  plorth::parser::basic_token_stream<std::u32string::const_iterator> stream(
+    std::cbegin(source),
+    std::cend(source)
+  );
+  auto it = stream.begin();
+
+  assert(it != stream.end());
+  assert(!!*it);
+  assert((**it)->type() == token::type::symbol);
+  assert(stream.position().offset == 3);
+
+  ++it;
+  assert(it != stream.end());
+  assert(!!*it);
+  assert(stream.position().offset == 7);
+
+  ++it;
+  assert(it != stream.end());
+  assert(!*it);
+  assert(it->error().position.line == 1);
+
+  ++it;
+  assert(it == stream.end());
+}
+
+static void
+test_empty_source()
+{
+  auto stream = plorth::parser::parse_lazily("");
+
+  assert(stream.begin() == stream.end());
+}
+
+static void
+test_resumes_where_it_left()
+{
+  auto stream = plorth::parser::parse_lazily("a b c");
+  std::size_t count = 0;
+  auto it = stream.begin();
+
+  assert(!!*it);
+  ++it;
+  for (const auto& result : stream)
+  {
+    assert(!!result);
+    ++count;
+  }
+  assert(count == 2);
+  assert(stream.begin() == stream.end());
+}
+
+int
+main()
+{
+  test_yields_same_tokens_as_parse();
+  test_parses_one_token_at_a_time();
+  test_empty_source();
+  test_resumes_where_it_left();
+}
@@ -0,0 +1,212 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/traversal.hpp>
+
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+
+static plorth::parser::parse_result
+parse(const char* source)
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  return plorth::parser::parse(source, position);
+}
+
+// Describes the visited tokens by type, and symbols by their identifier.
+template<class TraversalT>
+static std::u32string
+describe(TraversalT& traversal)
+{
+  std::u32string result;
+
+  for (const auto& token : traversal)
+  {
+    if (token->type() == token::type::symbol)
+    {
+      result += std::static_pointer_cast<symbol>(token)->id();
+    } else {
+      result += static_cast<char32_t>(token->type());
+    }
+  }
+
+  return result;
+}
+
+static void
+test_pre_order()
+{
+  const auto result = parse("a [b, (c d), {\"k\": e}] () f");
+
+  assert(!!result);
+
+  plorth::parser::ast::pre_order_traversal traversal(*result);
+
+  assert(describe(traversal) == U"a[b(cd{e(f");
+}
+
+static void
+test_post_order()
+{
+  const auto result = parse("a [b, (c d), {\"k\": e}] () f");
+
+  assert(!!result);
+
+  plorth::parser::ast::post_order_traversal traversal(*result);
+
+  assert(describe(traversal) == U"abcd(e{[(f");
+}
+
+static void
+test_word_symbol()
+{
+  const auto result = parse("-> foo (-> bar baz) [-> qux]");
+
+  assert(!!result);
+
+  plorth::parser::ast::pre_order_traversal pre(*result);
+  plorth::parser::ast::post_order_traversal post(*result);
+
+  assert(describe(pre) == U":foo(:barbaz[:qux");
+  assert(describe(post) == U"foo:bar:baz(qux:[");
+
+  std::vector<std::size_t> depths;
+
+  for (auto it = pre.begin(); it != pre.end(); ++it)
+  {
+    depths.push_back(pre.depth());
+  }
+
+  assert((depths == std::vector<std::size_t>{ 0, 1, 0, 1, 2, 1, 0, 1, 2 }));
+}
+
+static void
+test_depth()
+{
+  const auto result = parse("[[[a]], b]");
+
+  assert(!!result);
+
+  plorth::parser::ast::pre_order_traversal traversal(*result);
+  std::vector<std::size_t> depths;
+
+  for (auto it = traversal.begin(); it != traversal.end(); ++it)
+  {
+    depths.push_back(traversal.depth());
+  }
+
+  assert((depths == std::vector<std::size_t>{ 0, 1, 2, 3, 1 }));
+}
+
+static void
+test_skip_children()
+{
+  const auto result = parse("[a, (b c), d] (e) f");
+
+  assert(!!result);
+
+  plorth::parser::ast::pre_order_traversal traversal(*result);
+  std::u32string visited;
+
+  for (auto it = traversal.begin(); it != traversal.end(); ++it)
+  {
+    const auto type = (*it)->type();
+
+    if (type == token::type::quote)
+    {
+      traversal.skip_children();
+    }
+    visited += type == token::type::symbol
+      ? static_cast<char32_t>('s')
+      : static_cast<char32_t>(type);
+  }
+
+  assert(visited == U"[s(s(s");
+}
+
+static void
+test_single_root()
+{
+  const auto result = parse("[a, [b]]");
+
+  assert(!!result);
+
+  plorth::parser::ast::post_order_traversal traversal(result->at(0));
+
+  assert(describe(traversal) == U"ab[[");
+  // Traversing again gives the same result.
+  assert(describe(traversal) == U"ab[[");
+}
+
+static void
+test_empty()
+{
+  const auto result = parse("");
+
+  assert(!!result);
+
+  plorth::parser::ast::pre_order_traversal pre(*result);
+  plorth::parser::ast::post_order_traversal post(*result);
+
+  assert(pre.begin() == pre.end());
+  assert(post.begin() == post.end());
+}
+
+static void
+test_deep_tree()
+{
+  const std::size_t depth = 100000;
+  std::shared_ptr<token> root;
+
+  {
+    plorth::parser::position position = { U"<test>", 1, 1 };
+
+    root = std::make_shared<plorth::parser::ast::quote>(
+      position,
+      plorth::parser::ast::quote::container_type()
+    );
+    for (std::size_t i = 1; i < depth; ++i)
+    {
+      root = std::make_shared<plorth::parser::ast::quote>(
+        position,
+        plorth::parser::ast::quote::container_type{ root }
+      );
+    }
+  }
+
+  plorth::parser::ast::post_order_traversal traversal(root);
+  std::size_t count = 0;
+
+  for (const auto& token : traversal)
+  {
+    assert(token->type() == token::type::quote);
+    ++count;
+  }
+  assert(count == depth);
+
+  // Release the tree one level at a time, since destructors of nested
+  // tokens recurse.
+  while (root)
+  {
+    const auto& children = std::static_pointer_cast<
+      plorth::parser::ast::quote
+    >(root)->children();
+    auto next = children.empty() ? nullptr : children[0];
+
+    root = std::move(next);
+  }
+}
+
+int
+main()
+{
+  test_pre_order();
+  test_post_order();
+  test_word_symbol();
+  test_depth();
+  test_skip_children();
+  test_single_root();
+  test_empty();
+  test_deep_tree();
+}
@@ -0,0 +1,103 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+
+using plorth::parser::ast::token;
+
+static void
+test_decode_ascii()
+{
+  assert(plorth::parser::utf8::decode("foo") == U"foo");
+}
+
+static void
+test_decode_multibyte()
+{
+  assert(
+    plorth::parser::utf8::decode("\xc3\xa4\xe2\x82\xac\xf0\x9f\x98\x80")
+    == U"ä€\U0001f600"
+  );
+}
+
+static void
+test_decode_malformed()
+{
+  // Lone continuation byte.
+  assert(plorth::parser::utf8::decode("\x80") == U"�");
+  // Truncated sequence.
+  assert(plorth::parser::utf8::decode("\xe2\x82") == U"��");
+  // Overlong encoding of slash.
+  assert(plorth::parser::utf8::decode("\xc0\xaf") == U"��");
+  // Encoded surrogate.
+  assert(plorth::parser::utf8::decode("\xed\xa0\x80") == U"���");
+}
+
+static void
+test_iterator()
+{
+  const std::string_view source("a\xc3\xa4" "b");
+  auto current = plorth::parser::utf8::begin(source);
+  const auto end = plorth::parser::utf8::end(source);
+
+  assert(current < end);
+  assert(*current++ == U'a');
+  assert(*current++ == U'ä');
+  assert(current - plorth::parser::utf8::begin(source) == 3);
+  assert(*current++ == U'b');
+  assert(current == end);
+}
+
+static void
+test_parse()
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    "[\"\xc3\xa4\\u00e4\", 'x'] (p\xc3\xa4\xc3\xa4) {\"k\": v}",
+    position
+  );
+
+  assert(!!result);
+  assert(result->size() == 3);
+  assert(result->at(0)->type() == token::type::array);
+  assert(result->at(1)->type() == token::type::quote);
+  assert(result->at(2)->type() == token::type::object);
+
+  const auto array = std::static_pointer_cast<plorth::parser::ast::array>(
+    result->at(0)
+  );
+  const auto string = std::static_pointer_cast<plorth::parser::ast::string>(
+    array->elements()[0]
+  );
+  const auto quote = std::static_pointer_cast<plorth::parser::ast::quote>(
+    result->at(1)
+  );
+  const auto symbol = std::static_pointer_cast<plorth::parser::ast::symbol>(
+    quote->children()[0]
+  );
+
+  assert(string->value() == U"ää");
+  assert(symbol->id() == U"pää");
+  assert(position.line == 1);
+  assert(position.column == 32);
+}
+
+static void
+test_parse_error()
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse("[\"\xc3\xa4", position);
+
+  assert(!result);
+  assert(result.error().position.column == 2);
+}
+
+int
+main()
+{
+  test_decode_ascii();
+  test_decode_multibyte();
+  test_decode_malformed();
+  test_iterator();
+  test_parse();
+  test_parse_error();
+}
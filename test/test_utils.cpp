@@ -94,6 +94,46 @@ test_isword()
   assert(isword(U'\u00e4'));
   assert(isword(U':'));
   assert(isword(U';'));
+  assert(!isword(U'\x7f'));
+  assert(!isword(U'\u3000'));
+}
+
+static void
+test_isspace()
+{
+  using plorth::parser::utils::isspace;
+
+  assert(isspace(U' '));
+  assert(isspace(U'\t'));
+  assert(isspace(U'\n'));
+  assert(isspace(U'\r'));
+  assert(isspace(U'\u3000'));
+
+  assert(!isspace(U'a'));
+  assert(!isspace(U'#'));
+  assert(!isspace(U'\u00e4'));
+  assert(!isspace(U'\U00010120'));
+}
+
+static void
+test_ascii_class_table()
+{
+  using namespace plorth::parser::utils;
+
+  static_assert(ascii_class_table['"'] & ascii_quote);
+  static_assert(ascii_class_table['\''] & ascii_quote);
+  static_assert(ascii_class_table['#'] & ascii_comment);
+  static_assert(ascii_class_table['{'] == ascii_delimiter);
+  static_assert(ascii_class_table['\n'] == ascii_whitespace);
+  static_assert(ascii_class_table[0xe4] == 0);
+
+  // Word characters must agree with the scanning kernels.
+  for (char32_t c = 0; c < 128; ++c)
+  {
+    const auto skipped = plorth::parser::scan::scalar::skip_word(&c, &c + 1);
+
+    assert(isword(c) == (skipped != &c));
+  }
 }
 
 int
@@ -104,4 +144,6 @@ main()
   test_peek_advance();
   test_skip_whitespace();
   test_isword();
+  test_isspace();
+  test_ascii_class_table();
 }
@@ -0,0 +1,144 @@
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+#include <plorth/parser/validate.hpp>
+
+static std::size_t allocations = 0;
+
+// GCC cannot see that the replacement operators below are paired correctly.
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void*
+operator new(std::size_t size)
+{
+  ++allocations;
+  if (auto pointer = std::malloc(size))
+  {
+    return pointer;
+  }
+
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+static const char* inputs[] =
+{
+  "",
+  "foo",
+  "foo -> bar",
+  "\"foo\\n\\u00e4\" 'bar'",
+  "[1, [2, (3 4)], {\"a\": {\"b\": []}},]",
+  "# comment\n(a b c) # another",
+  "\"pää\" äö",
+  "[",
+  "[1 2]",
+  "[1,",
+  "[,]",
+  "{",
+  "{\"a\"",
+  "{\"a\" 1}",
+  "{a: 1}",
+  "{\"a\": 1 \"b\": 2}",
+  "{\"a\":",
+  "(foo",
+  "\"foo",
+  "'\\x'",
+  "'\\u12'",
+  "]",
+  "foo ]",
+  "->",
+  "-> ]",
+  "-> (foo)",
+  "foo ",
+  "[(1, {\"a\": [1, 2,]}) ",
+};
+
+static void
+test_same_result_as_parse()
+{
+  for (const auto input : inputs)
+  {
+    plorth::parser::position position1 = { U"<test>", 1, 1 };
+    plorth::parser::position position2 = { U"<test>", 1, 1 };
+    const auto expected = plorth::parser::parse(input, position1);
+    const auto error = plorth::parser::validate(input, position2);
+
+    assert(!expected == !!error);
+    if (error)
+    {
+      assert(error->message == expected.error().message);
+      assert(error->position.offset == expected.error().position.offset);
+      assert(error->position.line == expected.error().position.line);
+      assert(error->position.column == expected.error().position.column);
+    } else {
+      assert(position1.offset == position2.offset);
+    }
+  }
+}
+
+static void
+test_same_result_as_parse_utf32()
+{
+  for (const auto input : inputs)
+  {
+    const auto source = plorth::parser::utf8::decode(input);
+    auto current1 = std::cbegin(source);
+    auto current2 = std::cbegin(source);
+    plorth::parser::position position1 = { U"<test>", 1, 1 };
+    plorth::parser::position position2 = { U"<test>", 1, 1 };
+    const auto expected = plorth::parser::parse(
+      current1,
+      std::cend(source),
+      position1
+    );
+    const auto error = plorth::parser::validate(
+      current2,
+      std::cend(source),
+      position2
+    );
+
+    assert(!expected == !!error);
+    if (error)
+    {
+      assert(error->message == expected.error().message);
+      assert(error->position.offset == expected.error().position.offset);
+    }
+  }
+}
+
+static void
+test_does_not_allocate()
+{
+  const std::string source =
+    "foo \"bar\\n\" -> baz 'quux' # comment\n\"pää\\u00e4\"";
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto decoded = plorth::parser::utf8::decode(source);
+  auto current = std::cbegin(decoded);
+
+  allocations = 0;
+  assert(!plorth::parser::validate(source, position));
+  assert(!plorth::parser::validate(current, std::cend(decoded), position));
+  assert(allocations == 0);
+}
+
+int
+main()
+{
+  test_same_result_as_parse();
+  test_same_result_as_parse_utf32();
+  test_does_not_allocate();
+}
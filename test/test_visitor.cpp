@@ -1,6 +1,6 @@
 #include <cassert>
 
-#include <plorth/parser/ast.hpp>
+#include <plorth/parser.hpp>
 #include <plorth/parser/visitor.hpp>
 
 using plorth::parser::ast::array;
@@ -9,6 +9,7 @@ using plorth::parser::ast::quote;
 using plorth::parser::ast::string;
 using plorth::parser::ast::symbol;
 using plorth::parser::ast::token;
+using plorth::parser::ast::static_visitor;
 using plorth::parser::ast::visitor;
 using plorth::parser::ast::word;
 
@@ -144,6 +145,87 @@ test_visit_token()
   assert(flag);
 }
 
+// Counts symbols in the tree, descending into arrays and quotes.
+class counting_visitor : public static_visitor<counting_visitor, int>
+{
+public:
+  int visit_array(const array& token, const std::u32string& id)
+  {
+    int count = 0;
+
+    for (const auto& element : token.elements())
+    {
+      count += visit(element, id);
+    }
+
+    return count;
+  }
+
+  int visit_quote(const quote& token, const std::u32string& id)
+  {
+    int count = 0;
+
+    for (const auto& child : token.children())
+    {
+      count += visit(child, id);
+    }
+
+    return count;
+  }
+
+  int visit_symbol(const symbol& token, const std::u32string& id)
+  {
+    ++visited;
+
+    return token.id() == id ? 1 : 0;
+  }
+
+  int visited = 0;
+};
+
+static void
+test_static_visitor()
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = plorth::parser::parse(
+    "[foo, (bar foo \"foo\"), {\"foo\": foo}] foo -> foo",
+    position
+  );
+  counting_visitor visitor;
+  int count = 0;
+
+  assert(!!result);
+  for (const auto& token : *result)
+  {
+    count += visitor.visit(*token, U"foo");
+  }
+
+  assert(count == 3);
+  assert(visitor.visited == 4);
+  assert(visitor.visit(std::shared_ptr<token>(), U"foo") == 0);
+}
+
+static void
+test_static_visitor_visit_token()
+{
+  class another_test_visitor : public static_visitor<another_test_visitor>
+  {
+  public:
+    void visit_token(const token& token, bool& flag)
+    {
+      flag = token.type() == token::type::word;
+    }
+  };
+  another_test_visitor visitor;
+  auto symbol = std::make_shared<class symbol>(position, U"test");
+  auto token = std::make_shared<word>(position, symbol);
+  bool flag = false;
+
+  visitor.visit(token, flag);
+
+  assert(flag);
+}
+
 int
 main()
 {
@@ -154,4 +236,6 @@ main()
   test_visit_symbol();
   test_visit_word();
   test_visit_token();
+  test_static_visitor();
+  test_static_visitor_visit_token();
 }
@@ -0,0 +1,125 @@
+#include <cassert>
+
+#include <plorth/parser.hpp>
+#include <plorth/parser/visitor_runner.hpp>
+
+using plorth::parser::ast::symbol;
+using plorth::parser::ast::token;
+using plorth::parser::ast::visitor;
+
+// Records types of the visited tokens.
+class recording_visitor : public visitor<std::u32string&>
+{
+public:
+  explicit recording_visitor(char32_t name)
+    : m_name(name) {}
+
+  void visit_token(const std::shared_ptr<token>& token, std::u32string& log)
+    const
+  {
+    log += m_name;
+    log += static_cast<char32_t>(token->type());
+  }
+
+private:
+  const char32_t m_name;
+};
+
+// Counts symbols with given identifier.
+class symbol_counter : public visitor<std::u32string&>
+{
+public:
+  explicit symbol_counter(const std::u32string& id)
+    : m_id(id) {}
+
+  void visit_symbol(const std::shared_ptr<symbol>& token, std::u32string&)
+    const
+  {
+    if (token->id() == m_id)
+    {
+      ++count;
+    }
+  }
+
+  mutable int count = 0;
+
+private:
+  const std::u32string m_id;
+};
+
+static plorth::parser::parse_result
+parse(const char* source)
+{
+  plorth::parser::position position = { U"<test>", 1, 1 };
+
+  return plorth::parser::parse(source, position);
+}
+
+static void
+test_single_traversal()
+{
+  const auto result = parse("a [\"b\", (a c)] -> a");
+  const recording_visitor all(U'1');
+  const recording_visitor containers(U'2');
+  const symbol_counter counter(U"a");
+  plorth::parser::ast::visitor_runner<std::u32string&> runner;
+  std::u32string log;
+
+  assert(!!result);
+
+  runner.add(all);
+  runner.add(
+    containers,
+    plorth::parser::ast::type_mask(token::type::array, token::type::quote)
+  );
+  runner.add(counter, plorth::parser::ast::type_mask(token::type::symbol));
+  runner.run(*result, log);
+
+  assert(log == U"1s1[2[1\"1(2(1s1s1:1s");
+  assert(counter.count == 3);
+}
+
+static void
+test_single_token()
+{
+  const auto result = parse("[a, [b]]");
+  const recording_visitor all(U'1');
+  plorth::parser::ast::visitor_runner<std::u32string&> runner;
+  std::u32string log;
+
+  assert(!!result);
+
+  runner.add(all, plorth::parser::ast::type_mask(token::type::array));
+  runner.run(result->at(0), log);
+
+  assert(log == U"1[1[");
+}
+
+static void
+test_type_mask()
+{
+  using plorth::parser::ast::type_mask;
+
+  static_assert(type_mask() == 0);
+  static_assert(
+    type_mask(
+      token::type::array,
+      token::type::object,
+      token::type::quote,
+      token::type::string,
+      token::type::symbol,
+      token::type::word
+    ) == plorth::parser::ast::all_types
+  );
+  static_assert(
+    type_mask(token::type::array) != type_mask(token::type::word)
+  );
+}
+
+int
+main()
+{
+  test_single_traversal();
+  test_single_token();
+  test_type_mask();
+}
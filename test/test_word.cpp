@@ -55,6 +55,26 @@ static void test_parse()
   );
 }
 
+static void test_position()
+{
+  const std::u32string source(U"-> foo bar");
+  auto begin = std::cbegin(source);
+  const auto end = std::cend(source);
+  plorth::parser::position position = { U"<test>", 1, 1 };
+  const auto result = parse_symbol_or_word<std::u32string::const_iterator>(
+    begin,
+    end,
+    position
+  );
+  const auto word = std::static_pointer_cast<plorth::parser::ast::word>(
+    *result
+  );
+
+  assert(word->position().column == 1);
+  assert(word->symbol()->position().column == 4);
+  assert(position.column == 7);
+}
+
 int
 main()
 {
@@ -62,4 +82,5 @@ main()
   test_no_arrow_found();
   test_no_symbol_found();
   test_parse();
+  test_position();
 }